@@ -0,0 +1,101 @@
+/*
+ * ================================================================
+ * ALLOCATOR THROUGHPUT BENCHMARK
+ * ================================================================
+ *
+ * Replays a fixed, seeded alloc/free churn against the classic
+ * allocator (all three strategies) and the buddy allocator, and
+ * reports operations per second.
+ *
+ * Usage: ./memsim_bench [operations]
+ *
+ * Simulator output is discarded so that the numbers reflect the
+ * allocator data structures rather than the terminal.
+ * ================================================================
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <streambuf>
+
+#include "memory_allocator.h"
+#include "buddy_allocator.h"
+
+using namespace std;
+
+// Stream buffer that swallows everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct BenchResult {
+    long long operations;
+    double seconds;
+};
+
+// Alloc/free churn: keep roughly `live_target` blocks alive, freeing a random one
+template <typename Allocator>
+BenchResult runChurn(Allocator& allocator, long long operations, size_t max_request, size_t live_target) {
+    mt19937 rng(12345);
+    uniform_int_distribution<size_t> size_dist(1, max_request);
+    vector<int> live;
+    live.reserve(live_target * 2);
+    
+    auto start = chrono::steady_clock::now();
+    for (long long i = 0; i < operations; i++) {
+        bool do_alloc = live.empty() || (live.size() < live_target && (rng() & 1));
+        if (do_alloc) {
+            int id = allocator.allocate(size_dist(rng));
+            if (id != -1) live.push_back(id);
+        } else {
+            size_t k = rng() % live.size();
+            allocator.deallocate(live[k]);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    
+    return { operations, chrono::duration<double>(end - start).count() };
+}
+
+void report(const string& label, const BenchResult& r) {
+    double ops_per_sec = r.seconds > 0 ? r.operations / r.seconds : 0.0;
+    cerr << "  " << left << setw(24) << label << right
+         << setw(12) << r.operations << " ops  "
+         << fixed << setprecision(3) << setw(8) << r.seconds << " s  "
+         << setprecision(0) << setw(12) << ops_per_sec << " ops/sec\n";
+}
+
+int main(int argc, char* argv[]) {
+    long long operations = (argc > 1) ? stoll(argv[1]) : 200000;
+    
+    NullBuffer null_buffer;
+    streambuf* saved = cout.rdbuf(&null_buffer);
+    
+    cerr << "Allocator benchmark (" << operations << " operations per run)\n";
+    
+    const AllocationStrategy strategies[] = {
+        AllocationStrategy::FIRST_FIT, AllocationStrategy::BEST_FIT, AllocationStrategy::WORST_FIT
+    };
+    const char* names[] = { "classic first_fit", "classic best_fit", "classic worst_fit" };
+    for (int i = 0; i < 3; i++) {
+        MemoryManager manager(1 << 24);
+        manager.setStrategy(strategies[i]);
+        report(names[i], runChurn(manager, operations, 512, 4096));
+    }
+    
+    {
+        BuddyAllocator buddy(1 << 24, 16);
+        report("buddy", runChurn(buddy, operations, 512, 4096));
+    }
+    
+    cout.rdbuf(saved);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef BELADY_ORACLE_H
+#define BELADY_ORACLE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// ==================== BELADY OPT ORACLE ====================
+//
+// Records the address stream one level sees during trace replay, then
+// replays it offline under FIFO, LRU and Belady's OPT (evict the entry
+// whose next use is farthest away). OPT needs the future, so next-use
+// indices are precomputed in one backward pass over the stream; each set
+// keeps its resident entries in a max-heap keyed by next use, giving
+// O(log n) per access.
+
+struct OracleResult {
+    uint64_t accesses;
+    uint64_t fifo_misses;
+    uint64_t lru_misses;
+    uint64_t opt_misses;
+    
+    OracleResult() : accesses(0), fifo_misses(0), lru_misses(0), opt_misses(0) {}
+};
+
+class BeladyOracle {
+private:
+    vector<uint64_t> addresses;
+    
+    // Helper functions
+    void computeNextUse(const vector<uint64_t>& keys, vector<size_t>& next_use) const;
+    uint64_t simulateOpt(const vector<uint64_t>& keys, int sets, int ways) const;
+    uint64_t simulateQueue(const vector<uint64_t>& keys, int sets, int ways, bool move_on_hit) const;
+
+public:
+    void record(uint64_t address) { addresses.push_back(address); }
+    void clear() { addresses.clear(); }
+    size_t size() const { return addresses.size(); }
+    
+    // Misses of a sets x ways cache of unit-byte entries (pages or blocks)
+    // over the recorded stream; a set holds key % sets
+    OracleResult simulate(uint64_t unit, int sets, int ways) const;
+};
+
+#endif // BELADY_ORACLE_H
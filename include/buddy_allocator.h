@@ -3,8 +3,10 @@
 
 #include <iostream>
 #include <vector>
-#include <map>
 #include <cstddef>
+#include <cstdint>
+#include "node_pool.h"
+#include "event_sink.h"
 
 using namespace std;
 
@@ -16,9 +18,17 @@ struct BuddyBlock {
     bool is_free;
     int block_id;
     BuddyBlock* next;
+    BuddyBlock* prev;
     
     BuddyBlock(size_t addr, size_t sz, int id = -1) 
-        : address(addr), size(sz), is_free(true), block_id(id), next(nullptr) {}
+        : address(addr), size(sz), is_free(true), block_id(id), next(nullptr), prev(nullptr) {}
+};
+
+// ==================== BUDDY BACKEND ENUM ====================
+
+enum class BuddyBackend {
+    FREE_LIST,  // Buddy lookup scans the free list of that order
+    BITMAP      // Per-order free bitmaps + slot table: O(1) buddy lookup/removal
 };
 
 // ==================== ALLOCATION RECORD STRUCTURE ====================
@@ -30,6 +40,20 @@ struct AllocationRecord {
     int order;
 };
 
+// ==================== ALLOCATION SLOT STRUCTURE ====================
+
+// Entry of the block_id-indexed allocation table.
+// The generation is bumped on every allocate and free, so it is odd while
+// the slot holds a live allocation and a stale (block_id, generation) pair
+// can be told apart from the current occupant.
+struct AllocationSlot {
+    AllocationRecord record;
+    uint32_t generation;
+    
+    AllocationSlot() : record(), generation(0) {}
+    bool isLive() const { return (generation & 1) != 0; }
+};
+
 // ==================== BUDDY ALLOCATOR CLASS ====================
 
 class BuddyAllocator {
@@ -37,9 +61,17 @@ private:
     size_t total_memory;
     size_t min_block_size;
     int max_order;
+    BuddyBackend backend;
     
-    vector<BuddyBlock*> free_lists;
-    map<int, AllocationRecord> allocated_blocks;
+    vector<BuddyBlock*> free_lists;        // Doubly linked, newest block at head
+    uint64_t nonempty_orders;              // Bit k set if free_lists[k] is non-empty
+    NodePool<BuddyBlock> block_pool;       // Storage for free-list nodes
+    
+    // Bitmap backend only
+    vector<vector<uint64_t>> free_bitmaps; // free_bitmaps[order]: bit i = block i of that order is free
+    vector<BuddyBlock*> slot_nodes;        // Free-list node of the free block starting at each min-size slot
+    vector<AllocationSlot> allocated_blocks;   // Indexed by block_id
+    size_t live_blocks;                        // Slots currently live
     
     int next_block_id;
     
@@ -52,6 +84,8 @@ private:
     int merges;
     size_t total_internal_fragmentation;
     
+    EventSink* sink;                       // nullptr = no event reporting
+    
     // Helper functions
     bool isPowerOfTwo(size_t n);
     int getOrder(size_t size);
@@ -59,17 +93,22 @@ private:
     size_t getBuddyAddress(size_t address, size_t size);
     size_t nextPowerOfTwo(size_t size);
     bool splitBlock(int order);
+    void pushFreeBlock(int order, BuddyBlock* block);
+    BuddyBlock* popFreeBlock(int order);
+    void unlinkFreeBlock(int order, BuddyBlock* block);
     BuddyBlock* removeFromFreeList(int order, size_t address);
-    bool mergeBlocks(size_t address, int order);
+    bool mergeBlocks(BuddyBlock* block, int order);
     
 public:
     // Constructor & Destructor
-    BuddyAllocator(size_t memory_size, size_t min_size = 16);
+    BuddyAllocator(size_t memory_size, size_t min_size = 16,
+                   BuddyBackend backend_type = BuddyBackend::FREE_LIST);
     ~BuddyAllocator();
     
     // Main operations
     int allocate(size_t requested_size);
     bool deallocate(int block_id);
+    void setEventSink(EventSink* event_sink);
     
     // Display functions
     void displayFreeLists() const;
@@ -79,6 +118,8 @@ public:
     size_t getTotalMemory() const { return total_memory; }
     size_t getMinBlockSize() const { return min_block_size; }
     int getMaxOrder() const { return max_order; }
+    BuddyBackend getBackend() const { return backend; }
+    uint32_t getBlockGeneration(int block_id) const;
     int getSuccessfulAllocations() const { return successful_allocations; }
     int getFailedAllocations() const { return failed_allocations; }
     int getSplits() const { return splits; }
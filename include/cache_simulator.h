@@ -4,6 +4,11 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "event_sink.h"
+#include "prefetcher.h"
 
 using namespace std;
 
@@ -11,8 +16,13 @@ using namespace std;
 
 // Cache replacement policy
 enum class ReplacementPolicy {
-    FIFO,  // First In First Out
-    LRU    // Least Recently Used
+    FIFO,       // First In First Out
+    LRU,        // Least Recently Used
+    TREE_PLRU,  // Binary tree pseudo-LRU (ways - 1 bits per set)
+    BIT_PLRU,   // MRU-bit pseudo-LRU (one bit per way)
+    SRRIP,      // Static RRIP: 2-bit RRPV, insert at "long" re-reference
+    BRRIP,      // Bimodal RRIP: insert at "distant", 1 in 32 at "long"
+    RANDOM      // Seeded pseudo-random victim
 };
 
 // Cache write policy (NEW)
@@ -26,18 +36,51 @@ enum class AssociativityType {
     DIRECT_MAPPED,      // 1-way: Each address maps to exactly one line
     TWO_WAY,            // 2-way set associative
     FOUR_WAY,           // 4-way set associative
+    N_WAY,              // Any other way count (CacheLevelConfig::ways)
     FULLY_ASSOCIATIVE   // Any address can go anywhere
 };
 
-// Cache Line (Entry)
-struct CacheLine {
-    bool valid;             // Is this entry valid?
-    size_t tag;             // Address tag
-    bool dirty;             // Modified but not written to memory (for write-back)
-    int insertion_order;    // For FIFO
-    int last_access_time;   // For LRU
+// Geometry and policies of one cache level
+struct CacheLevelConfig {
+    int lines;                          // Total cache lines (0 = level absent)
+    int block_size;                     // Block size in bytes
+    AssociativityType associativity;
+    int ways;                           // Ways per set when associativity is N_WAY
+    ReplacementPolicy replacement;
+    uint64_t random_seed;               // RANDOM victim sequence seed
+    WritePolicy write_policy;
     
-    CacheLine() : valid(false), tag(0), dirty(false), insertion_order(0), last_access_time(0) {}
+    CacheLevelConfig()
+        : lines(0), block_size(64), associativity(AssociativityType::FULLY_ASSOCIATIVE), ways(0),
+          replacement(ReplacementPolicy::LRU), random_seed(1), write_policy(WritePolicy::WRITE_BACK) {}
+};
+
+// Line displaced by a fill
+struct CacheVictim {
+    bool valid;        // False if the fill used an empty way
+    size_t address;    // First byte of the displaced block
+    bool dirty;
+    
+    CacheVictim() : valid(false), address(0), dirty(false) {}
+};
+
+// Where a block may live across levels. INCLUSIVE and EXCLUSIVE track
+// blocks by address, so every level must use the same block size.
+enum class InclusionPolicy {
+    NINE,       // Non-inclusive non-exclusive: fill every level, no back-invalidation
+    INCLUSIVE,  // Lower levels hold every upper block; their victims are back-invalidated
+    EXCLUSIVE   // A block lives in one level; L1 fills only, victims move down
+};
+
+// Cycle costs of the hierarchy (index 0..2 = L1..L3). A hit at level n
+// costs hit[n]; a lookup that misses costs miss[n] before the next level
+// is tried. The defaults are the classic 1/10/50/100 cycle model.
+struct CacheLatencyConfig {
+    int hit[3];
+    int miss[3];
+    int memory;
+    
+    CacheLatencyConfig() : hit{1, 10, 50}, miss{1, 10, 50}, memory(100) {}
 };
 
 // ==================== CACHE CLASS (Internal Helper) ====================
@@ -48,48 +91,124 @@ private:
     int capacity;                          // Total number of cache lines
     int block_size;                        // Block size in bytes
     AssociativityType associativity;       // Type of associativity
-    ReplacementPolicy replacement_policy;  // FIFO or LRU
+    ReplacementPolicy replacement_policy;  // See ReplacementPolicy
     WritePolicy write_policy;              // Write-through or Write-back
     
     int num_sets;                          // Number of sets
     int ways;                              // Ways per set (associativity)
     
-    vector<vector<CacheLine>> cache;       // cache[set][way]
+    // Power-of-two block size and set count: index/tag by shift and mask
+    bool pow2_geometry;
+    int block_shift;
+    int tag_shift;
+    size_t set_mask;
+    
+    // Line storage, structure-of-arrays. Way w of set s is entry
+    // s * way_stride + w; per-set bitmasks use mask_words 64-bit words.
+    int way_stride;                        // ways rounded up to the SIMD width
+    int mask_words;                        // Bitmask words per set
+    vector<uint64_t> tags;                 // Address tags, contiguous per set
+    vector<uint64_t> valid_bits;           // Bit w set: way w holds a line
+    vector<uint64_t> dirty_bits;           // Bit w set: modified (write-back)
+    vector<uint64_t> insertion_order;      // Fill stamp (shown by cache_contents)
+    vector<uint64_t> last_access_time;     // Access stamp (shown by cache_contents)
+    
+    // Recency order per set (FIFO and LRU only): head = most recently
+    // used (LRU) or most recently filled (FIFO), tail = victim once the
+    // set is full. Sets of up to 16 ways pack the order into one word,
+    // 4 bits per position; wider sets keep a doubly linked list of valid ways.
+    bool tracks_order;
+    bool packed_order;
+    vector<uint64_t> order_perm;           // Packed: nibble i = way at position i
+    vector<int> order_prev;                // Linked: per-way links, -1 terminated
+    vector<int> order_next;
+    vector<int> order_head;                // Linked: per set
+    vector<int> order_tail;                // Linked: per set
+    vector<int> lines_used;                // Linked: valid ways per set
+    
+    // Fixed-size per-set state of the other policies
+    int plru_leaves;                       // Tree-PLRU: ways rounded up to a power of two
+    int plru_words;                        // PLRU bitmask words per set
+    vector<uint64_t> plru_bits;            // Tree-PLRU node bits (root = bit 1) or MRU bits
+    vector<uint8_t> rrpv;                  // RRIP: re-reference prediction value per line
+    uint64_t rrip_fills;                   // BRRIP: fills since start, picks "long" inserts
+    uint64_t random_seed;
+    uint64_t random_state;                 // RANDOM: splitmix64 state
+    
+    // Prefetched lines no demand access has used yet (empty unless a
+    // prefetcher is attached to this level)
+    vector<uint64_t> prefetch_bits;        // Per-set bitmask like valid_bits
+    vector<uint64_t> prefetch_ready;       // Cycle the prefetched block arrives
+    bool last_hit_prefetched;              // Last demand hit used a prefetched line
+    uint64_t last_hit_ready;
+    uint64_t prefetch_fills;
+    uint64_t prefetch_useful;              // Used by a demand access
+    uint64_t prefetch_late;                // Used before the block arrived
+    uint64_t prefetch_useless;             // Evicted unused
+    
+    // Fully associative fast path: tag -> way index
+    bool use_tag_index;
+    unordered_map<uint64_t, int> tag_index;
     
     // Tracking counters
-    int next_insertion_order;              // For FIFO
-    int access_counter;                    // For LRU
+    uint64_t next_insertion_order;         // For FIFO
+    uint64_t access_counter;               // For LRU
     
     // Statistics
-    int hits;
-    int misses;
-    int writes;                            // Total write operations
-    int write_hits;                        // Writes that hit
-    int write_misses;                      // Writes that miss
-    int writebacks;                        // Write-backs to memory (dirty evictions)
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t writes;                       // Total write operations
+    uint64_t write_hits;                   // Writes that hit
+    uint64_t write_misses;                 // Writes that miss
+    uint64_t writebacks;                   // Write-backs to memory (dirty evictions)
     
     // Helper functions
-    int getSetIndex(size_t address);
-    size_t getTag(size_t address);
+    int getSetIndex(size_t address) const;
+    size_t getTag(size_t address) const;
+    size_t lineIndex(int set_index, int way) const { return (size_t)set_index * way_stride + way; }
+    bool testBit(const vector<uint64_t>& bits, int set_index, int way) const;
+    void setBit(vector<uint64_t>& bits, int set_index, int way, bool value);
+    int findWay(int set_index, uint64_t tag) const;
+    void linkFront(int set_index, int way);
+    void unlinkWay(int set_index, int way);
+    void moveToFront(int set_index, int way);
+    void touchWay(int set_index, int way);
+    size_t blockAddress(int set_index, uint64_t tag) const;
+    CacheVictim fillLine(int set_index, int way, uint64_t tag, bool dirty, uint64_t access_time);
+    int firstEmptyWay(int set_index) const;
     int findVictimInSet(int set_index);
-    int findFIFOVictimInSet(int set_index);
-    int findLRUVictimInSet(int set_index);
+    void notePrefetchHit(int set_index, int way);
+    void resetPolicyState();
+    void touchPlruTree(int set_index, int way);
+    void touchPlruBits(int set_index, int way);
+    int plruTreeVictim(int set_index) const;
+    int plruBitsVictim(int set_index) const;
+    int rripVictim(int set_index);
+    uint64_t nextRandom();
     
 public:
-    Cache(string cache_name, int total_lines, int blk_size, 
-          AssociativityType assoc, ReplacementPolicy repl_pol, WritePolicy wr_pol);
+    Cache(string cache_name, const CacheLevelConfig& config);
 
     // Read operation
     bool read(size_t address);
     
-    // Write operation 
-    bool write(size_t address);
+    // Write operation (write-allocate; victim receives the displaced line)
+    bool write(size_t address, CacheVictim* victim = nullptr);
     
-    // Insert (for hierarchy updates)
-    void insert(size_t address, bool is_dirty = false);
+    // Insert (for hierarchy updates); returns the displaced line
+    CacheVictim insert(size_t address, bool is_dirty = false);
     
     // Evict and return if dirty (for write-back policy) 
     bool evict(size_t address, bool& was_dirty);
+    bool invalidate(size_t address, bool& was_dirty);   // No write-back counted
+    void residentBlocks(vector<size_t>& addresses) const;
+    
+    // Prefetch support
+    bool contains(size_t address) const;          // Lookup without statistics
+    void enablePrefetchTracking();
+    bool prefetch(size_t address, uint64_t ready_cycle, CacheVictim* victim = nullptr);  // False if present
+    bool hitPrefetchedLine() const { return last_hit_prefetched; }
+    uint64_t prefetchWait(uint64_t now);           // Cycles a late prefetch still needs
     
     // bool access(size_t address);
     // void insert(size_t address);
@@ -97,10 +216,15 @@ public:
     // Display functions
     void displayStats() const;
     double getHitRatio() const;
-    int getHits() const;
-    int getMisses() const;
-    int getTotalAccesses() const;
-    int getWritebacks() const; 
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+    uint64_t getTotalAccesses() const;
+    uint64_t getWritebacks() const;
+    const string& getName() const { return name; }
+    int getBlockSize() const { return block_size; }
+    int getCapacity() const { return capacity; }
+    int getNumSets() const { return num_sets; }
+    int getWays() const { return ways; }
     WritePolicy getWritePolicy() const;  // Get the write policy for this cache
     void clear();
     void displayContents() const;
@@ -118,38 +242,95 @@ private:
     bool has_l3;
     
     // Overall statistics
-    int total_accesses;
-    int total_reads;                    
-    int total_writes;                   
-    int l1_hits;
-    int l2_hits;
-    int l3_hits;
-    int memory_accesses;
-    int memory_writes;                  // Writes to main memory
-    
-    // Miss penalties (in cycles)
-    int l1_penalty;
-    int l2_penalty;
-    int l3_penalty;
-    int memory_penalty;
-    
-    int total_penalty_cycles;
+    uint64_t total_accesses;
+    uint64_t total_reads;
+    uint64_t total_writes;
+    uint64_t l1_hits;
+    uint64_t l2_hits;
+    uint64_t l3_hits;
+    uint64_t memory_accesses;
+    uint64_t memory_writes;             // Writes to main memory
+    uint64_t memory_writebacks;         // ...of which dirty victims leaving the last level
+    
+    // Inclusion between levels
+    InclusionPolicy inclusion;
+    uint64_t back_invalidations;        // Upper copies removed for inclusion
+    uint64_t dirty_back_invalidations;
+    uint64_t victims_moved;             // Exclusive: victims swapped one level down
+    
+    CacheLatencyConfig latency;         // Hit/miss/memory cycle costs
+    
+    // Optional prefetcher per level (nullptr = none)
+    Prefetcher* prefetchers[3];
+    uint64_t prefetch_memory_reads;     // Extra memory traffic from prefetches
+    vector<uint64_t> prefetch_candidates;
+    
+    // Optional fully associative LRU victim cache behind L1 (nullptr = none);
+    // it holds L1 victims and swaps a hit line back into L1
+    Cache* victim_cache;
+    int victim_latency;                 // Cycles for a victim-cache hit
+    uint64_t victim_probes;             // L1 misses that checked the victim cache
+    uint64_t victim_hits;
+    
+    // Miss-status holding registers for L1 misses. An entry stays
+    // outstanding for mshr_window cycles; another miss to its block in
+    // that time merges instead of going below L1.
+    struct MshrEntry {
+        size_t block;
+        uint64_t retire_cycle;
+    };
+    vector<MshrEntry> mshrs;
+    int mshr_entries;                   // 0 = MSHRs not modelled
+    uint64_t mshr_window;
+    uint64_t mshr_merges;
+    uint64_t mshr_full_stalls;          // Misses that waited for a free MSHR
+    uint64_t mshr_stall_cycles;
+    
+    // Cycle accounting
+    uint64_t total_penalty_cycles;
+    uint64_t read_cycles;
+    uint64_t write_cycles;
+    uint64_t level_cycles[4];           // Spent in L1, L2, L3 and memory
+    
+    // Helper functions
+    void chargeCycles(int level, int cycles, int& penalty);
+    double levelAmat(int level) const;
+    Cache* levelCache(int level) const;
+    int nextLevel(int level) const;
+    bool lookup(int level, size_t address, bool is_write, int& penalty);
+    bool takeFromVictimCache(size_t address, bool& dirty);
+    bool trackL1Miss(size_t address, int& penalty);
+    bool serveL1Miss(size_t address, bool is_write, bool victim_hit, bool victim_dirty, int& penalty);
+    void issuePrefetches(int level, size_t address, uint64_t now);
+    bool cachedOutside(int level, size_t address) const;
+    void fillLevel(int level, size_t address, bool dirty);
+    void promote(int level, size_t address, bool dirty);
+    void handleVictim(int level, const CacheVictim& victim);
+    bool backInvalidate(Cache* cache, size_t address);
+    void writeBackBelow(int level, size_t address);
+    
+    EventSink* sink;                    // nullptr = no event reporting
     
 public:
-    CacheHierarchy(int l1_lines, int l1_block, AssociativityType l1_assoc, 
-                   ReplacementPolicy l1_repl, WritePolicy l1_write,
-                   int l2_lines, int l2_block, AssociativityType l2_assoc, 
-                   ReplacementPolicy l2_repl, WritePolicy l2_write,
-                   int l3_lines, int l3_block, AssociativityType l3_assoc, 
-                   ReplacementPolicy l3_repl, WritePolicy l3_write);
+    CacheHierarchy(const CacheLevelConfig& l1_config,
+                   const CacheLevelConfig& l2_config,
+                   const CacheLevelConfig& l3_config,
+                   const CacheLatencyConfig& latency_config = CacheLatencyConfig(),
+                   InclusionPolicy inclusion_policy = InclusionPolicy::NINE);
     ~CacheHierarchy();
     
     // Main operations
-    bool read(size_t address, bool verbose = true);      // explicit read
-    bool write(size_t address, bool verbose = true);     // explicit write
-    bool access(size_t address, bool verbose = true);    // Generic access (read)
+    void setEventSink(EventSink* event_sink);
+    bool setPrefetcher(int level, const PrefetchConfig& config);   // level 1..3
+    void removePrefetcher(int level);
+    bool setVictimCache(int entries, int hit_latency = 1);   // entries 0 = remove
+    void setMshrs(int entries, uint64_t window);              // entries 0 = off
+    bool read(size_t address);          // explicit read
+    bool write(size_t address);         // explicit write
+    bool access(size_t address);        // Generic access (read)
     bool has_l2_level() const {return has_l2; }
     bool has_l3_level() const {return has_l3; }
+    bool levelGeometry(int level, int& sets, int& ways, int& block_size) const;   // level 1..3
     
     // Display functions
     void displayStats() const;
@@ -159,7 +340,11 @@ public:
 
 // ==================== HELPER FUNCTIONS ====================
 
-AssociativityType parseAssociativity(string assoc_str);
+AssociativityType parseAssociativity(string assoc_str, int& ways);
+ReplacementPolicy parseReplacementPolicy(string policy_str, uint64_t& seed);
+bool parseInclusionPolicy(const string& policy_str, InclusionPolicy& policy);
+string inclusionPolicyName(InclusionPolicy policy);
+string replacementPolicyName(ReplacementPolicy policy);
 WritePolicy parseWritePolicy(string write_str);  
 
 #endif // CACHE_SIMULATOR_H
\ No newline at end of file
@@ -0,0 +1,166 @@
+#ifndef EVENT_SINK_H
+#define EVENT_SINK_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// ==================== SIMULATION EVENTS ====================
+//
+// The simulation cores never format output themselves. Each notable step
+// is reported as a SimEvent to the attached EventSink; with no sink (or a
+// NullEventSink) attached the cores skip event construction entirely.
+// Field use per event type is listed next to each enumerator.
+
+enum class SimEventType : uint8_t {
+    // Unified system (a = address, b = physical address)
+    ACCESS_BEGIN,            // a = address; flags VM
+    ACCESS_TRANSLATED,       // b = physical address
+    ACCESS_TRANSLATION_FAILED,
+    ACCESS_CACHE_BEGIN,      // level bit n set if Ln exists; flags WRITE, CACHE
+    ACCESS_END,              // a, b; flags WRITE, VM, CACHE, MEMORY, BUDDY
+    ALLOC_REQUEST,
+    FREE_REQUEST,
+    NO_ALLOCATOR,
+    
+    // Classic allocator
+    ALLOC_ZERO_SIZE,         // Shared with the buddy allocator
+    ALLOC_NO_MEMORY,         // a = size
+    ALLOC_SUCCESS,           // a = block id, b = address, c = size
+    FREE_NOT_FOUND,          // a = block id
+    FREE_SUCCESS,            // a = block id
+    
+    // Buddy allocator
+    BUDDY_TOO_LARGE,         // a = requested size
+    BUDDY_REQUEST,           // a = request number, b = requested, c = rounded, d = order
+    BUDDY_SPLIT,             // a = order with no free block
+    BUDDY_SPLIT_FAILED,
+    BUDDY_OUT_OF_MEMORY,
+    BUDDY_ALLOC_SUCCESS,     // a = block id, b = address, c = block size, d = internal fragmentation
+    BUDDY_FREE_INVALID,      // a = block id
+    BUDDY_FREE,              // a = block id, b = address, c = block size, d = order
+    BUDDY_MERGED,            // a = merges performed
+    
+    // Virtual memory
+    VM_ADDRESS_INVALID,      // a = virtual address
+    VM_TRANSLATE,            // a = virtual address, b = page, c = offset
+    VM_PAGE_HIT,             // a = virtual address, b = frame, c = physical address
+    VM_PAGE_FAULT,           // a = virtual address, b = page
+    VM_FAULT_RESOLVED,       // a = physical address
+    VM_FREE_FRAME,           // a = frame
+    VM_NO_FREE_FRAME,
+    VM_VICTIM_SELECTED,      // a = page, b = policy stamp (see selectVictimPage), c = PageReplacementPolicy
+    VM_VICTIM_MISSING,
+    VM_EVICT_INVALID,
+    VM_PAGE_EVICTED,         // a = page, b = frame; flags DIRTY
+    VM_PAGE_LOADED,          // a = page, b = frame
+    
+    // Cache hierarchy (level = 1..3)
+    CACHE_ACCESS,            // a = address; flags WRITE
+    CACHE_HIT,               // a = hit latency, b = total cycles; flags WRITE, WRITE_THROUGH
+    CACHE_MISS,              // a = miss penalty, b = next level checked (0 = memory); flags WRITE
+    CACHE_MEMORY,            // a = memory penalty, b = total cycles; flags WRITE, WRITE_THROUGH
+    CACHE_PROMOTE,           // Line copied up after a lower-level hit (level 0 = all upper levels)
+    CACHE_FILL,              // Line filled after a memory access; flags WRITE, DIRTY
+    CACHE_VICTIM_HIT,        // a = victim cache latency, b = total cycles; flags WRITE
+    CACHE_MSHR_MERGE,        // a = block address
+    CACHE_MSHR_STALL         // a = stall cycles (all MSHRs busy)
+};
+
+const uint8_t EVENT_WRITE = 0x01;
+const uint8_t EVENT_DIRTY = 0x02;
+const uint8_t EVENT_WRITE_THROUGH = 0x04;
+const uint8_t EVENT_VM = 0x08;
+const uint8_t EVENT_CACHE = 0x10;
+const uint8_t EVENT_MEMORY = 0x20;
+const uint8_t EVENT_BUDDY = 0x40;
+
+struct SimEvent {
+    SimEventType type;
+    uint8_t level;
+    uint8_t flags;
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+    uint64_t d;
+    
+    SimEvent(SimEventType t, uint64_t a_val = 0, uint64_t b_val = 0,
+             uint64_t c_val = 0, uint64_t d_val = 0, uint8_t lvl = 0, uint8_t f = 0)
+        : type(t), level(lvl), flags(f), a(a_val), b(b_val), c(c_val), d(d_val) {}
+};
+
+// ==================== EVENT SINK INTERFACE ====================
+
+class EventSink {
+public:
+    virtual ~EventSink() {}
+    virtual void emit(const SimEvent& event) = 0;
+    
+    // False if events would be discarded; components then drop the sink
+    virtual bool enabled() const { return true; }
+};
+
+// Helper: Sink pointer a component should keep (nullptr = no subscriber)
+inline EventSink* activeSink(EventSink* sink) {
+    return (sink != nullptr && sink->enabled()) ? sink : nullptr;
+}
+
+// ==================== NULL SINK ====================
+
+// Throughput mode: attaching it detaches all event reporting
+class NullEventSink : public EventSink {
+public:
+    void emit(const SimEvent&) override {}
+    bool enabled() const override { return false; }
+};
+
+// ==================== TEXT SINK ====================
+
+// Formats events as the simulator's interactive console output
+class TextEventSink : public EventSink {
+private:
+    ostream& out;
+    bool verbose;            // Cache steps and detailed page translation
+    
+    void emitSystem(const SimEvent& event);
+    void emitAllocator(const SimEvent& event);
+    void emitVirtualMemory(const SimEvent& event);
+    void emitCache(const SimEvent& event);
+
+public:
+    TextEventSink(ostream& stream) : out(stream), verbose(false) {}
+    
+    void emit(const SimEvent& event) override;
+    void setVerbose(bool v) { verbose = v; }
+    bool isVerbose() const { return verbose; }
+};
+
+// ==================== BINARY SINK ====================
+
+// Fixed 36-byte little-endian records after a 16-byte "MSEV" header
+class BinaryEventSink : public EventSink {
+private:
+    ofstream out;
+    vector<uint8_t> buffer;
+    uint64_t event_count;
+    
+    void flushBuffer();
+
+public:
+    BinaryEventSink();
+    ~BinaryEventSink();
+    
+    bool open(const string& path);
+    bool close();            // Patches the event count into the header
+    bool isOpen() const { return out.is_open(); }
+    
+    void emit(const SimEvent& event) override;
+    uint64_t getEventCount() const { return event_count; }
+};
+
+#endif // EVENT_SINK_H
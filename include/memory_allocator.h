@@ -4,6 +4,12 @@
 #include <iostream>
 #include <string>
 #include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "node_pool.h"
+#include "event_sink.h"
 
 // ==================== MEMORY BLOCK STRUCTURE ====================
 
@@ -20,6 +26,34 @@ struct MemoryBlock {
           block_id(id), next(nullptr), prev(nullptr) {}
 };
 
+// ==================== FREE BLOCK INDEX ORDERINGS ====================
+
+// Orders free blocks by start address (used inside each size class)
+struct FreeBlockByAddress {
+    using is_transparent = void;
+    bool operator()(const MemoryBlock* a, const MemoryBlock* b) const {
+        return a->start_address < b->start_address;
+    }
+};
+
+// Orders free blocks by (size, start address) for best/worst fit lookups
+struct FreeBlockBySize {
+    using is_transparent = void;
+    bool operator()(const MemoryBlock* a, const MemoryBlock* b) const {
+        if (a->size != b->size) return a->size < b->size;
+        return a->start_address < b->start_address;
+    }
+    // Probe form: compare against a (size, start_address) key
+    bool operator()(const MemoryBlock* a, const std::pair<size_t, size_t>& key) const {
+        if (a->size != key.first) return a->size < key.first;
+        return a->start_address < key.second;
+    }
+    bool operator()(const std::pair<size_t, size_t>& key, const MemoryBlock* b) const {
+        if (key.first != b->size) return key.first < b->size;
+        return key.second < b->start_address;
+    }
+};
+
 // ==================== ALLOCATION STRATEGY ENUM ====================
 
 enum class AllocationStrategy {
@@ -34,20 +68,39 @@ class MemoryManager {
 private:
     size_t total_memory;
     MemoryBlock* head;
+    NodePool<MemoryBlock> block_pool;      // Storage for all list nodes
     AllocationStrategy strategy;
     int next_block_id;
     
+    // Free block index (kept in sync with the address-ordered list)
+    // Size class k holds free blocks with size in [2^k, 2^(k+1))
+    static const int NUM_SIZE_CLASSES = 64;
+    std::vector<std::set<MemoryBlock*, FreeBlockByAddress>> free_classes;
+    uint64_t nonempty_classes;                          // Bit k set if class k has blocks
+    std::set<MemoryBlock*, FreeBlockBySize> free_by_size;
+    
+    // Allocated block lookup (block_id -> block)
+    std::unordered_map<int, MemoryBlock*> block_lookup;
+    
+    // Running counters (free block count and largest free block come from free_by_size)
+    size_t used_memory;
+    
     // Allocation tracking
     int allocation_attempts;
     int allocation_successes;
     int allocation_failures;
     
+    EventSink* sink;                       // nullptr = no event reporting
+    
     // Helper functions
     MemoryBlock* findBlockFirstFit(size_t size);
     MemoryBlock* findBlockBestFit(size_t size);
     MemoryBlock* findBlockWorstFit(size_t size);
+    static int sizeClass(size_t size);
+    void indexFreeBlock(MemoryBlock* block);
+    void unindexFreeBlock(MemoryBlock* block);
     void splitBlock(MemoryBlock* block, size_t size);
-    void coalesceBlocks();
+    MemoryBlock* coalesceBlocks(MemoryBlock* block);
     
 public:
     // Constructor & Destructor
@@ -58,6 +111,7 @@ public:
     void setStrategy(AllocationStrategy s);
     int allocate(size_t size);
     bool deallocate(int block_id);
+    void setEventSink(EventSink* event_sink);
     
     // Display functions
     void displayMemory() const;
@@ -68,6 +122,7 @@ public:
     size_t getFreeMemory() const;
     double getExternalFragmentation() const;
     int countFreeBlocks() const;
+    size_t getLargestFreeBlock() const;
     double getAllocationSuccessRate() const;
     int getAllocationAttempts() const;
     int getAllocationSuccesses() const;
@@ -0,0 +1,65 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ==================== NODE POOL ====================
+//
+// Slab-backed storage for list nodes (MemoryBlock, BuddyBlock).
+// Nodes live in contiguous slabs of SlabSize entries; released slots go on
+// a free stack and are handed out again before a new slab is allocated,
+// so steady-state split/merge churn does no heap allocation.
+// Node addresses stay stable for the lifetime of the pool.
+
+template <typename T, size_t SlabSize = 256>
+class NodePool {
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+    
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    std::vector<T*> free_slots;
+    size_t in_use;
+    
+    // Add a slab; its lowest slots are handed out first
+    void grow() {
+        slabs.emplace_back(new Slot[SlabSize]);
+        T* base = reinterpret_cast<T*>(slabs.back().get());
+        for (size_t i = SlabSize; i > 0; i--) {
+            free_slots.push_back(base + (i - 1));
+        }
+    }
+    
+public:
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "NodePool frees slabs without running node destructors");
+    
+    NodePool() : in_use(0) {}
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    
+    // Construct a node in a free slot
+    template <typename... Args>
+    T* acquire(Args&&... args) {
+        if (free_slots.empty()) grow();
+        T* slot = free_slots.back();
+        free_slots.pop_back();
+        in_use++;
+        return new (slot) T(std::forward<Args>(args)...);
+    }
+    
+    // Return a node's slot to the pool
+    void release(T* node) {
+        free_slots.push_back(node);
+        in_use--;
+    }
+    
+    size_t inUse() const { return in_use; }
+    size_t capacity() const { return slabs.size() * SlabSize; }
+};
+
+#endif // NODE_POOL_H
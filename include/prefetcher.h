@@ -0,0 +1,77 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// ==================== PREFETCHER CONFIGURATION ====================
+
+enum class PrefetchType {
+    NEXT_LINE,  // Blocks following the trigger block
+    STRIDE,     // Constant stride detected per 4 KB region (no PC)
+    STREAM      // Stream buffers following ascending/descending misses
+};
+
+struct PrefetchConfig {
+    PrefetchType type;
+    int degree;      // Blocks requested per trigger
+    int distance;    // Blocks (or strides) ahead of the trigger block
+    
+    PrefetchConfig() : type(PrefetchType::NEXT_LINE), degree(1), distance(1) {}
+};
+
+// ==================== PREFETCHER CLASS ====================
+
+// Trained by one cache level on demand misses and on first demand hits
+// to prefetched lines; proposes block numbers for that level to fetch.
+class Prefetcher {
+private:
+    PrefetchType type;
+    int degree;
+    int distance;
+    int block_size;
+    
+    // Stride: direct-mapped table of 4 KB regions
+    struct StrideEntry {
+        bool valid;
+        uint64_t region;
+        uint64_t last_block;
+        int64_t stride;
+        int confidence;    // Repeats of stride seen (saturates at 3)
+    };
+    vector<StrideEntry> stride_table;
+    
+    // Stream: a buffer is tentative (direction 0) until a second trigger
+    // near its last block fixes the direction
+    struct StreamBuffer {
+        bool valid;
+        uint64_t last_block;
+        int direction;
+        uint64_t next_block;       // First block not yet requested
+        uint64_t last_use;         // For LRU reallocation
+    };
+    vector<StreamBuffer> streams;
+    uint64_t stream_clock;
+    
+    // Helper functions
+    void trainStride(uint64_t block, vector<uint64_t>& candidates);
+    void trainStream(uint64_t block, vector<uint64_t>& candidates);
+
+public:
+    Prefetcher(const PrefetchConfig& config, int blk_size);
+    
+    // Appends the block numbers to prefetch after a trigger at block
+    void train(uint64_t block, vector<uint64_t>& candidates);
+    void reset();
+    string describe() const;
+};
+
+// ==================== HELPER FUNCTIONS ====================
+
+bool parsePrefetchType(const string& type_str, PrefetchType& type);
+
+#endif // PREFETCHER_H
@@ -0,0 +1,119 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// ==================== BINARY TRACE FORMAT ====================
+//
+// File layout (all multi-byte header fields little-endian):
+//   Header (16 bytes): magic "MSTR", u16 version, u16 flags, u64 record count
+//   Records:           1 op byte, then LEB128 varint payload
+//
+// Op byte: bits 0-2 = TraceOp, bit 3 = pid varint follows the payload.
+// Payload by op:
+//   READ / WRITE  zigzag varint of (address - previous READ/WRITE address)
+//   MALLOC        varint size in bytes
+//   FREE          varint block id
+//   COMMAND       varint length + raw command text (init/set/... lines)
+
+const char TRACE_MAGIC[4] = { 'M', 'S', 'T', 'R' };
+const uint16_t TRACE_VERSION = 1;
+const size_t TRACE_HEADER_SIZE = 16;
+
+enum class TraceOp : uint8_t {
+    READ = 0,
+    WRITE = 1,
+    MALLOC = 2,
+    FREE = 3,
+    COMMAND = 4
+};
+
+const uint8_t TRACE_OP_MASK = 0x07;
+const uint8_t TRACE_HAS_PID = 0x08;
+
+// One decoded record; text points into the mapped file (COMMAND only)
+struct TraceRecord {
+    TraceOp op;
+    uint64_t value;          // Address, size or block id
+    bool has_pid;
+    uint32_t pid;
+    const char* text;
+    size_t text_length;
+    
+    TraceRecord() : op(TraceOp::READ), value(0), has_pid(false), pid(0), text(nullptr), text_length(0) {}
+};
+
+// ==================== BINARY TRACE WRITER ====================
+
+class BinaryTraceWriter {
+private:
+    ofstream out;
+    uint64_t record_count;
+    uint64_t previous_address;
+    vector<uint8_t> buffer;
+    
+    void putVarint(uint64_t value);
+    void flushBuffer();
+
+public:
+    BinaryTraceWriter();
+    ~BinaryTraceWriter();
+    
+    bool open(const string& path);
+    void writeAccess(bool is_write, uint64_t address, bool has_pid = false, uint32_t pid = 0);
+    void writeMalloc(uint64_t size, bool has_pid = false, uint32_t pid = 0);
+    void writeFree(uint64_t block_id, bool has_pid = false, uint32_t pid = 0);
+    void writeCommand(const string& text);
+    bool close();            // Patches the record count into the header
+    
+    uint64_t getRecordCount() const { return record_count; }
+};
+
+// ==================== BINARY TRACE READER ====================
+
+// Memory-mapped, zero-copy reader
+class BinaryTraceReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    const uint8_t* cursor;
+    uint64_t record_count;
+    uint64_t records_read;
+    uint64_t previous_address;
+    bool corrupt;
+
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#else
+    int fd;
+#endif
+
+    bool getVarint(uint64_t& value);
+
+public:
+    BinaryTraceReader();
+    ~BinaryTraceReader();
+    
+    bool open(const string& path);
+    bool next(TraceRecord& record);   // False at end of trace or on corrupt data
+    void close();
+    
+    uint64_t getRecordCount() const { return record_count; }
+    uint64_t getRecordsRead() const { return records_read; }
+    bool isCorrupt() const { return corrupt; }
+};
+
+// ==================== HELPER FUNCTIONS ====================
+
+bool isBinaryTrace(const string& path);
+bool convertTextTrace(const string& text_path, const string& binary_path);
+
+#endif // TRACE_FORMAT_H
@@ -5,6 +5,9 @@
 #include <vector>
 #include <string>
 #include <cstddef>
+#include <cstdint>
+#include "event_sink.h"
+#include "cache_simulator.h"
 
 using namespace std;
 
@@ -14,20 +17,58 @@ struct PageTableEntry {
     bool valid;              // Is page in physical memory?
     int frame_number;        // Physical frame number (-1 if not in memory)
     bool dirty;              // Has page been modified?
+    bool referenced;         // Accessed since the policy last cleared it
     int last_access_time;    // For LRU replacement
     int load_time;           // For FIFO replacement
     int access_count;        // For statistics
+    uint32_t age;            // Aging shift register (MSB = latest tick)
     
     PageTableEntry() 
-        : valid(false), frame_number(-1), dirty(false),
-          last_access_time(0), load_time(0), access_count(0) {}
+        : valid(false), frame_number(-1), dirty(false), referenced(false),
+          last_access_time(0), load_time(0), access_count(0), age(0) {}
+};
+
+// ==================== RADIX PAGE TABLE ====================
+//
+// x86-64 style: each table below the root indexes 9 bits of the virtual
+// page number (512 entries) and the root takes the remaining high bits,
+// so a 48-bit space with 4 KB pages walks 4 levels and a 57-bit space 5.
+// Tables are created the first time a page under them is touched; each
+// entry is modelled as 8 bytes of page-table memory.
+
+struct PageTableNode {
+    vector<int> children;               // Directory: child node per entry (-1 = not allocated)
+    vector<PageTableEntry> entries;     // Leaf: one PTE per page
 };
 
 // ==================== PAGE REPLACEMENT POLICY ENUM ====================
 
 enum class PageReplacementPolicy {
     FIFO,
-    LRU
+    LRU,
+    CLOCK,           // Hand sweeps frames, clearing reference bits
+    SECOND_CHANCE,   // FIFO, but a referenced head page is requeued once
+    ENHANCED_CLOCK,  // NRU classes by (referenced, dirty); clean unreferenced first
+    AGING            // Per-page shift register aged on every fault; lowest value goes
+};
+
+// ==================== TLB CONFIGURATION ====================
+
+// Translation lookaside buffers in front of the page table. Each level is
+// a Cache keyed by virtual page number (block_size 1, lines = entries).
+// A lookup costs l1_latency, plus l2_latency on an L1 miss, plus
+// walk_latency when both miss and the page table is walked.
+struct TlbConfig {
+    CacheLevelConfig l1;                // L1 dTLB (lines 0 = no TLB)
+    CacheLevelConfig l2;                // L2 TLB (lines 0 = absent)
+    int l1_latency;
+    int l2_latency;
+    int walk_latency;
+    
+    TlbConfig() : l1_latency(1), l2_latency(7), walk_latency(30) {
+        l1.block_size = 1;
+        l2.block_size = 1;
+    }
 };
 
 // ==================== VIRTUAL MEMORY SIMULATOR CLASS ====================
@@ -39,17 +80,37 @@ private:
     size_t physical_memory_size;
     size_t page_size;
     
-    int num_virtual_pages;
+    uint64_t num_virtual_pages;
     int num_physical_frames;
     
     PageReplacementPolicy policy;
+    int aging_bits;              // Width of the aging shift register (1..32)
+    int clock_hand;              // Next frame the clock policies examine
     
-    // Page table (one entry per virtual page)
-    vector<PageTableEntry> page_table;
+    // Page table: node 0 is the root. Nodes move when the vector grows,
+    // but their entry buffers do not, so PTE pointers stay valid.
+    vector<PageTableNode> page_table;
+    int page_table_levels;
+    int root_bits;               // Page-number bits indexed by the root
+    uint64_t page_table_entries; // Entries across all allocated tables
     
     // Frame allocation tracking
-    vector<int> frame_to_page;   // Maps frame number to page number (-1 if free)
-    vector<bool> frame_used;     // Is frame occupied?
+    vector<uint64_t> frame_to_page;          // Maps frame number to page number (NO_PAGE if free)
+    vector<PageTableEntry*> frame_to_pte;    // ...and to that page's entry
+    vector<uint64_t> free_frame_bits;   // Bit f set: frame f is free
+    int free_frames;
+    int free_word_hint;          // No free frame in bitmap words below this
+    
+    // Resident pages, linked through their frames: head = oldest. Both
+    // orders are kept so the policy can change between faults.
+    struct FrameList {
+        vector<int> prev;
+        vector<int> next;
+        int head;
+        int tail;
+    };
+    FrameList load_order;        // FIFO: by load time
+    FrameList recency_order;     // LRU: by last access
     
     // Statistics
     int page_faults;
@@ -58,25 +119,60 @@ private:
     int disk_reads;
     int disk_writes;
     int current_time;
+    uint64_t hand_movements;     // Pages examined by Clock/Second-Chance/Enhanced Clock
+    uint64_t levels_walked;      // Page-table levels visited by translations
+    
+    // TLBs (nullptr = translations go straight to the page table)
+    Cache* l1_tlb;
+    Cache* l2_tlb;
+    TlbConfig tlb_config;
+    uint64_t tlb_lookups;
+    uint64_t l1_tlb_hits;
+    uint64_t l2_tlb_hits;
+    uint64_t page_walks;         // Lookups that missed every TLB level
+    uint64_t translation_cycles; // TLB lookups plus page walks
     
-    bool verbose;
+    EventSink* sink;         // nullptr = no event reporting
     
     // Helper functions
-    void handlePageFault(int page_number);
+    void resetPageTable();
+    int allocateTable(int level);
+    int tableIndex(uint64_t page_number, int level) const;
+    PageTableEntry* findEntry(uint64_t page_number, bool allocate);
+    void resetFrames();
+    void setFrameFree(int frame, bool free);
+    void linkFrame(FrameList& list, int frame);
+    void unlinkFrame(FrameList& list, int frame);
+    void handlePageFault(uint64_t page_number);
     int findFreeFrame();
-    int selectVictimPage();
-    int evictPage(int page_number);
-    void loadPage(int page_number, int frame_number);
+    uint64_t selectVictimPage();
+    int advanceClockHand();
+    uint64_t clockVictim();
+    uint64_t secondChanceVictim();
+    uint64_t enhancedClockVictim();
+    uint64_t agingVictim();
+    void ageResidentPages();
+    string policyLabel() const;
+    int evictPage(uint64_t page_number);
+    void loadPage(uint64_t page_number, int frame_number);
+    bool lookupTlb(uint64_t page_number);
+    void fillTlb(uint64_t page_number);
+    void displayTlbStats();
     
 public:
     // Constructor
     VirtualMemorySimulator(size_t vm_size, size_t pm_size, size_t pg_size, string policy_str = "fifo");
+    ~VirtualMemorySimulator();
     
     // Main operations
     void setReplacementPolicy(string policy_str);
-    void setVerbose(bool v);
-    size_t translateAddress(size_t virtual_address);
+    void setEventSink(EventSink* event_sink);
+    bool configureTlb(const TlbConfig& config);   // False if the sizes or latencies are invalid
+    size_t translateAddress(size_t virtual_address, bool is_write = false);
     void access(size_t virtual_address);
+    size_t getPageSize() const { return page_size; }
+    int getNumFrames() const { return num_physical_frames; }
+    PageReplacementPolicy getPolicy() const { return policy; }
     
     // Display functions
     void displayPageTable();
@@ -86,4 +182,11 @@ public:
     void reset();
 };
 
+// ==================== HELPER FUNCTIONS ====================
+
+// Accepts fifo, lru, clock, second_chance, enhanced_clock and
+// aging[:bits]; aging_bits receives the register width (default 8)
+bool parsePageReplacementPolicy(const string& policy_str, PageReplacementPolicy& policy, int& aging_bits);
+string pageReplacementPolicyName(PageReplacementPolicy policy);
+
 #endif // VIRTUAL_MEMORY_SIMULATOR_H
\ No newline at end of file
@@ -12,74 +12,94 @@ using namespace std;
 // Constructor
 MemoryManager::MemoryManager(size_t size) 
     : total_memory(size), strategy(AllocationStrategy::FIRST_FIT), next_block_id(1),
-      allocation_attempts(0), allocation_successes(0), allocation_failures(0) {
-    head = new MemoryBlock(0, size, false, -1);
+      free_classes(NUM_SIZE_CLASSES), nonempty_classes(0), used_memory(0),
+      allocation_attempts(0), allocation_successes(0), allocation_failures(0),
+      sink(nullptr) {
+    head = block_pool.acquire(0, size, false, -1);
+    indexFreeBlock(head);
     cout << "Memory initialized: " << size << " bytes\n";
 }
 
-// Destructor
+// Destructor (list nodes are owned by block_pool)
 MemoryManager::~MemoryManager() {
-    MemoryBlock* current = head;
-    while (current != nullptr) {
-        MemoryBlock* next = current->next;
-        delete current;
-        current = next;
+}
+
+// Helper: Size class of a block (floor(log2(size)))
+int MemoryManager::sizeClass(size_t size) {
+    int k = 0;
+    while (size > 1) {
+        size >>= 1;
+        k++;
     }
+    return k;
 }
 
-// Find block using First Fit
-MemoryBlock* MemoryManager::findBlockFirstFit(size_t size) {
-    MemoryBlock* current = head;
-    while (current != nullptr) {
-        if (!current->is_allocated && current->size >= size) {
-            return current;
-        }
-        current = current->next;
+// Helper: Add a free block to the size-class and size-ordered indexes
+void MemoryManager::indexFreeBlock(MemoryBlock* block) {
+    int k = sizeClass(block->size);
+    free_classes[k].insert(block);
+    nonempty_classes |= (uint64_t(1) << k);
+    free_by_size.insert(block);
+}
+
+// Helper: Remove a free block from the indexes (must happen before its size changes)
+void MemoryManager::unindexFreeBlock(MemoryBlock* block) {
+    int k = sizeClass(block->size);
+    free_classes[k].erase(block);
+    if (free_classes[k].empty()) {
+        nonempty_classes &= ~(uint64_t(1) << k);
     }
-    return nullptr;
+    free_by_size.erase(block);
 }
 
-// Find block using Best Fit
-MemoryBlock* MemoryManager::findBlockBestFit(size_t size) {
-    MemoryBlock* current = head;
-    MemoryBlock* best = nullptr;
-    size_t min_diff = total_memory + 1;
+// Find block using First Fit (lowest-address free block that is large enough)
+MemoryBlock* MemoryManager::findBlockFirstFit(size_t size) {
+    int k = sizeClass(size);
+    MemoryBlock* first = nullptr;
     
-    while (current != nullptr) {
-        if (!current->is_allocated && current->size >= size) {
-            size_t diff = current->size - size;
-            if (diff < min_diff) {
-                min_diff = diff;
-                best = current;
-            }
+    // Every block in a class above k fits: take the lowest address among them
+    uint64_t larger = (k + 1 < NUM_SIZE_CLASSES) ? nonempty_classes & (~uint64_t(0) << (k + 1)) : 0;
+    while (larger != 0) {
+        int c = __builtin_ctzll(larger);
+        larger &= larger - 1;
+        MemoryBlock* candidate = *free_classes[c].begin();
+        if (first == nullptr || candidate->start_address < first->start_address) {
+            first = candidate;
+        }
+    }
+    
+    // Blocks in class k may be too small: walk them in address order, but
+    // only up to the best candidate found in the larger classes
+    for (MemoryBlock* candidate : free_classes[k]) {
+        if (first != nullptr && candidate->start_address > first->start_address) break;
+        if (candidate->size >= size) {
+            return candidate;
         }
-        current = current->next;
     }
-    return best;
+    return first;
+}
+
+// Find block using Best Fit (smallest sufficient size, lowest address on ties)
+MemoryBlock* MemoryManager::findBlockBestFit(size_t size) {
+    auto it = free_by_size.lower_bound(make_pair(size, (size_t)0));
+    if (it == free_by_size.end()) return nullptr;
+    return *it;
 }
 
-// Find block using Worst Fit
+// Find block using Worst Fit (largest size, lowest address on ties)
 MemoryBlock* MemoryManager::findBlockWorstFit(size_t size) {
-    MemoryBlock* current = head;
-    MemoryBlock* worst = nullptr;
-    size_t max_size = 0;
+    if (free_by_size.empty()) return nullptr;
     
-    while (current != nullptr) {
-        if (!current->is_allocated && current->size >= size) {
-            if (current->size > max_size) {
-                max_size = current->size;
-                worst = current;
-            }
-        }
-        current = current->next;
-    }
-    return worst;
+    size_t max_size = (*free_by_size.rbegin())->size;
+    if (max_size < size) return nullptr;
+    
+    return *free_by_size.lower_bound(make_pair(max_size, (size_t)0));
 }
 
-// Split block if needed
+// Split block if needed (block must not be in the free index)
 void MemoryManager::splitBlock(MemoryBlock* block, size_t size) {
     if (block->size > size) {
-        MemoryBlock* newBlock = new MemoryBlock(
+        MemoryBlock* newBlock = block_pool.acquire(
             block->start_address + size,
             block->size - size,
             false,
@@ -95,28 +115,46 @@ void MemoryManager::splitBlock(MemoryBlock* block, size_t size) {
         
         block->next = newBlock;
         block->size = size;
+        indexFreeBlock(newBlock);
     }
 }
 
-// Coalesce adjacent free blocks
-void MemoryManager::coalesceBlocks() {
-    MemoryBlock* current = head;
+// Coalesce a newly freed block with its free neighbours (returns the merged block)
+MemoryBlock* MemoryManager::coalesceBlocks(MemoryBlock* block) {
+    // Merge with next block
+    MemoryBlock* nextBlock = block->next;
+    if (nextBlock != nullptr && !nextBlock->is_allocated) {
+        unindexFreeBlock(block);
+        unindexFreeBlock(nextBlock);
+        
+        block->size += nextBlock->size;
+        block->next = nextBlock->next;
+        if (nextBlock->next != nullptr) {
+            nextBlock->next->prev = block;
+        }
+        
+        indexFreeBlock(block);
+        block_pool.release(nextBlock);
+    }
     
-    while (current != nullptr && current->next != nullptr) {
-        if (!current->is_allocated && !current->next->is_allocated) {
-            MemoryBlock* nextBlock = current->next;
-            current->size += nextBlock->size;
-            current->next = nextBlock->next;
-            
-            if (nextBlock->next != nullptr) {
-                nextBlock->next->prev = current;
-            }
-            
-            delete nextBlock;
-            continue;
+    // Merge into previous block
+    MemoryBlock* prevBlock = block->prev;
+    if (prevBlock != nullptr && !prevBlock->is_allocated) {
+        unindexFreeBlock(prevBlock);
+        unindexFreeBlock(block);
+        
+        prevBlock->size += block->size;
+        prevBlock->next = block->next;
+        if (block->next != nullptr) {
+            block->next->prev = prevBlock;
         }
-        current = current->next;
+        
+        indexFreeBlock(prevBlock);
+        block_pool.release(block);
+        block = prevBlock;
     }
+    
+    return block;
 }
 
 // Set allocation strategy
@@ -142,7 +180,7 @@ int MemoryManager::allocate(size_t size) {
     
     if (size == 0) {
         allocation_failures++;
-        cout << "Error: Cannot allocate 0 bytes\n";
+        if (sink) sink->emit(SimEvent(SimEventType::ALLOC_ZERO_SIZE));
         return -1;
     }
     
@@ -162,43 +200,50 @@ int MemoryManager::allocate(size_t size) {
     
     if (block == nullptr) {
         allocation_failures++;
-        cout << "Error: Not enough memory to allocate " << size << " bytes\n";
+        if (sink) sink->emit(SimEvent(SimEventType::ALLOC_NO_MEMORY, size));
         return -1;
     }
     
+    unindexFreeBlock(block);
     splitBlock(block, size);
     block->is_allocated = true;
     block->block_id = next_block_id;
+    block_lookup[next_block_id] = block;
+    used_memory += block->size;
     
     allocation_successes++;
     
-    cout << "Allocated block id=" << next_block_id 
-         << " at address=0x" << hex << setw(4) 
-         << setfill('0') << block->start_address 
-         << dec << " (" << size << " bytes)\n";
+    if (sink) {
+        sink->emit(SimEvent(SimEventType::ALLOC_SUCCESS, next_block_id, block->start_address, size));
+    }
     
     return next_block_id++;
 }
 
 // Free memory
 bool MemoryManager::deallocate(int block_id) {
-    MemoryBlock* current = head;
-    
-    while (current != nullptr) {
-        if (current->is_allocated && current->block_id == block_id) {
-            current->is_allocated = false;
-            current->block_id = -1;
-            
-            cout << "Block " << block_id << " freed";
-            coalesceBlocks();
-            cout << " and merged\n";
-            return true;
-        }
-        current = current->next;
+    auto it = block_lookup.find(block_id);
+    if (it == block_lookup.end()) {
+        if (sink) sink->emit(SimEvent(SimEventType::FREE_NOT_FOUND, (uint64_t)(int64_t)block_id));
+        return false;
     }
     
-    cout << "Error: Block " << block_id << " not found\n";
-    return false;
+    MemoryBlock* block = it->second;
+    block_lookup.erase(it);
+    
+    block->is_allocated = false;
+    block->block_id = -1;
+    used_memory -= block->size;
+    indexFreeBlock(block);
+    
+    coalesceBlocks(block);
+    if (sink) sink->emit(SimEvent(SimEventType::FREE_SUCCESS, block_id));
+    return true;
+}
+
+// Attach an event sink (nullptr or a NullEventSink disables reporting)
+void MemoryManager::setEventSink(EventSink* event_sink) {
+    sink = activeSink(event_sink);
 }
 
 // Display memory layout
@@ -225,53 +270,30 @@ void MemoryManager::displayMemory() const {
 
 // Get used memory
 size_t MemoryManager::getUsedMemory() const {
-    size_t used = 0;
-    MemoryBlock* current = head;
-    while (current != nullptr) {
-        if (current->is_allocated) {
-            used += current->size;
-        }
-        current = current->next;
-    }
-    return used;
+    return used_memory;
 }
 
 // Get free memory
 size_t MemoryManager::getFreeMemory() const {
-    return total_memory - getUsedMemory();
+    return total_memory - used_memory;
+}
+
+// Get largest free block
+size_t MemoryManager::getLargestFreeBlock() const {
+    if (free_by_size.empty()) return 0;
+    return (*free_by_size.rbegin())->size;
 }
 
 // Get external fragmentation
 double MemoryManager::getExternalFragmentation() const {
-    size_t largest_free = 0;
-    size_t total_free = 0;
-    MemoryBlock* current = head;
-    
-    while (current != nullptr) {
-        if (!current->is_allocated) {
-            total_free += current->size;
-            if (current->size > largest_free) {
-                largest_free = current->size;
-            }
-        }
-        current = current->next;
-    }
-    
+    size_t total_free = getFreeMemory();
     if (total_free == 0) return 0.0;
-    return ((double)(total_free - largest_free) / total_free) * 100.0;
+    return ((double)(total_free - getLargestFreeBlock()) / total_free) * 100.0;
 }
 
 // Count free blocks
 int MemoryManager::countFreeBlocks() const {
-    int count = 0;
-    MemoryBlock* current = head;
-    while (current != nullptr) {
-        if (!current->is_allocated) {
-            count++;
-        }
-        current = current->next;
-    }
-    return count;
+    return (int)free_by_size.size();
 }
 
 // Get allocation success rate
@@ -3,7 +3,6 @@
 #include <windows.h>
 #endif
 #include <vector>
-#include <map>
 #include <cmath>
 #include <iomanip>
 #include <sstream>
@@ -53,121 +52,152 @@ size_t  BuddyAllocator::nextPowerOfTwo(size_t size) {
     return power;
 }
 
-// Split a block into two buddies
+// Split down to `order`, starting from the smallest non-empty larger order
 bool  BuddyAllocator::splitBlock(int order) {
     if (order >= max_order) {
         return false;  // Cannot split beyond max order
     }
     
-    // Get a block from higher order
-    if (free_lists[order + 1] == nullptr) {
-        // Need to split higher order first
-        if (!splitBlock(order + 1)) {
-            return false;
-        }
+    // Find-first-set over the orders above the requested one
+    uint64_t larger = nonempty_orders >> (order + 1);
+    if (larger == 0) {
+        return false;  // No larger block available
     }
+    int from = order + 1 + __builtin_ctzll(larger);
     
-    if (free_lists[order + 1] == nullptr) {
-        return false;  // Still no block available
+    // Split one level at a time; the upper half is at the list head and is split next
+    for (int k = from; k > order; k--) {
+        BuddyBlock* block = popFreeBlock(k);
+        size_t new_size = getBlockSize(k - 1);
+        
+        // Reuse the node as the lower buddy, add a node for the upper buddy
+        block->size = new_size;
+        BuddyBlock* upper = block_pool.acquire(block->address + new_size, new_size);
+        
+        pushFreeBlock(k - 1, block);
+        pushFreeBlock(k - 1, upper);
+        
+        splits++;
     }
     
-    // Remove block from higher order
-    BuddyBlock* block = free_lists[order + 1];
-    free_lists[order + 1] = block->next;
-    
-    // Calculate size for this order
-    size_t new_size = getBlockSize(order);
-    
-    // Create two buddy blocks
-    BuddyBlock* buddy1 = new BuddyBlock(block->address, new_size);
-    BuddyBlock* buddy2 = new BuddyBlock(block->address + new_size, new_size);
-    
-    // Add both to current order's free list
-    buddy1->next = free_lists[order];
-    free_lists[order] = buddy1;
-    
-    buddy2->next = free_lists[order];
-    free_lists[order] = buddy2;
+    return true;
+}
+
+// Push a free block onto the head of its order's free list
+void  BuddyAllocator::pushFreeBlock(int order, BuddyBlock* block) {
+    block->prev = nullptr;
+    block->next = free_lists[order];
+    if (block->next != nullptr) {
+        block->next->prev = block;
+    }
+    free_lists[order] = block;
+    nonempty_orders |= (uint64_t(1) << order);
     
-    splits++;
-    delete block;
+    if (backend == BuddyBackend::BITMAP) {
+        size_t bit = block->address / getBlockSize(order);
+        free_bitmaps[order][bit / 64] |= (uint64_t(1) << (bit % 64));
+        slot_nodes[block->address / min_block_size] = block;
+    }
+}
+
+// Pop the head of an order's free list
+BuddyBlock*  BuddyAllocator::popFreeBlock(int order) {
+    BuddyBlock* block = free_lists[order];
+    if (block != nullptr) {
+        unlinkFreeBlock(order, block);
+    }
+    return block;
+}
+
+// Unlink a known free block from its order's free list
+void  BuddyAllocator::unlinkFreeBlock(int order, BuddyBlock* block) {
+    if (block->prev != nullptr) {
+        block->prev->next = block->next;
+    } else {
+        free_lists[order] = block->next;
+        if (free_lists[order] == nullptr) {
+            nonempty_orders &= ~(uint64_t(1) << order);
+        }
+    }
+    if (block->next != nullptr) {
+        block->next->prev = block->prev;
+    }
+    block->next = nullptr;
+    block->prev = nullptr;
     
-    return true;
+    if (backend == BuddyBackend::BITMAP) {
+        size_t bit = block->address / getBlockSize(order);
+        free_bitmaps[order][bit / 64] &= ~(uint64_t(1) << (bit % 64));
+        slot_nodes[block->address / min_block_size] = nullptr;
+    }
 }
 
 // Find and remove a block from free list
 BuddyBlock*  BuddyAllocator::removeFromFreeList(int order, size_t address) {
     if (free_lists[order] == nullptr) return nullptr;
     
-    // Check if first block matches
-    if (free_lists[order]->address == address) {
-        BuddyBlock* block = free_lists[order];
-        free_lists[order] = block->next;
-        return block;
-    }
+    BuddyBlock* block = nullptr;
     
-    // Search in list
-    BuddyBlock* current = free_lists[order];
-    while (current->next != nullptr) {
-        if (current->next->address == address) {
-            BuddyBlock* block = current->next;
-            current->next = block->next;
-            return block;
+    if (backend == BuddyBackend::BITMAP) {
+        // O(1): test the order's free bit, then take the node from the slot table
+        size_t bit = address / getBlockSize(order);
+        if (free_bitmaps[order][bit / 64] & (uint64_t(1) << (bit % 64))) {
+            block = slot_nodes[address / min_block_size];
+        }
+    } else {
+        // Search in list
+        for (BuddyBlock* current = free_lists[order]; current != nullptr; current = current->next) {
+            if (current->address == address) {
+                block = current;
+                break;
+            }
         }
-        current = current->next;
     }
     
-    return nullptr;
+    if (block != nullptr) {
+        unlinkFreeBlock(order, block);
+    }
+    return block;
 }
 
-// Try to merge block with its buddy
-bool  BuddyAllocator::mergeBlocks(size_t address, int order) {
-    if (order >= max_order) {
-        // Already at max order, cannot merge further
-        return false;
-    }
-    
-    size_t block_size = getBlockSize(order);
+// Merge a freed block (not yet on a free list) with its buddies, then insert it
+bool  BuddyAllocator::mergeBlocks(BuddyBlock* block, int order) {
+    bool merged = false;
     
-    // Calculate buddy address
-    size_t buddy_addr = getBuddyAddress(address, block_size);
-    
-    // Try to find buddy in free list
-    BuddyBlock* buddy = removeFromFreeList(order, buddy_addr);
-    
-    if (buddy == nullptr) {
-        // Buddy not free, cannot merge
-        return false;
+    while (order < max_order) {
+        size_t block_size = getBlockSize(order);
+        
+        // Try to find buddy in free list
+        size_t buddy_addr = getBuddyAddress(block->address, block_size);
+        BuddyBlock* buddy = removeFromFreeList(order, buddy_addr);
+        
+        if (buddy == nullptr) {
+            break;  // Buddy not free, cannot merge further
+        }
+        
+        // Merge in place: the block node now describes the combined block
+        if (buddy_addr < block->address) {
+            block->address = buddy_addr;
+        }
+        block->size = block_size * 2;
+        block_pool.release(buddy);
+        
+        merges++;
+        merged = true;
+        order++;
     }
     
-    // Buddy found! Remove current block from free list
-    removeFromFreeList(order, address);
-    
-    // Merge
-    size_t merged_addr = (address < buddy_addr) ? address : buddy_addr;
-    size_t merged_size = block_size * 2;
-    
-    // Add merged block to higher order
-    BuddyBlock* merged = new BuddyBlock(merged_addr, merged_size);
-    merged->next = free_lists[order + 1];
-    free_lists[order + 1] = merged;
-    
-    merges++;
-    delete buddy;
-    
-    // Try to merge recursively
-    mergeBlocks(merged_addr, order + 1);
-    
-    return true;
+    pushFreeBlock(order, block);
+    return merged;
 }
 
 // Constructor
-    BuddyAllocator::BuddyAllocator(size_t memory_size, size_t min_size) 
-    : total_memory(memory_size), min_block_size(min_size),
-        next_block_id(1),
+    BuddyAllocator::BuddyAllocator(size_t memory_size, size_t min_size, BuddyBackend backend_type) 
+    : total_memory(memory_size), min_block_size(min_size), backend(backend_type),
+        nonempty_orders(0), live_blocks(0), next_block_id(1),
         total_allocations(0), total_deallocations(0),
         successful_allocations(0), failed_allocations(0),
-        splits(0), merges(0), total_internal_fragmentation(0) {
+        splits(0), merges(0), total_internal_fragmentation(0), sink(nullptr) {
     
     // Validate memory size is power of 2
     if (!isPowerOfTwo(total_memory)) {
@@ -192,9 +222,19 @@ bool  BuddyAllocator::mergeBlocks(size_t address, int order) {
     // Initialize free lists
     free_lists.resize(max_order + 1, nullptr);
     
+    // Bitmap backend: one bit per block at every order, one node slot per min block
+    if (backend == BuddyBackend::BITMAP) {
+        free_bitmaps.resize(max_order + 1);
+        for (int i = 0; i <= max_order; i++) {
+            size_t blocks_at_order = total_memory / getBlockSize(i);
+            free_bitmaps[i].assign((blocks_at_order + 63) / 64, 0);
+        }
+        slot_nodes.assign(total_memory / min_block_size, nullptr);
+    }
+    
     // Add entire memory as one block at max order
-    BuddyBlock* initial = new BuddyBlock(0, total_memory);
-    free_lists[max_order] = initial;
+    BuddyBlock* initial = block_pool.acquire(0, total_memory);
+    pushFreeBlock(max_order, initial);
     
     cout << "Buddy Allocator initialized:\n";
     cout << "  Total memory: " << total_memory << " bytes\n";
@@ -202,18 +242,13 @@ bool  BuddyAllocator::mergeBlocks(size_t address, int order) {
     cout << "  Max order: " << max_order << "\n";
     cout << "  Orders: 0 (" << min_block_size << " bytes) to " 
             << max_order << " (" << total_memory << " bytes)\n";
+    if (backend == BuddyBackend::BITMAP) {
+        cout << "  Backend: per-order free bitmaps\n";
+    }
 }
 
-// Destructor
+// Destructor (free-list nodes are owned by block_pool)
     BuddyAllocator::~BuddyAllocator() {
-    for (int i = 0; i <= max_order; i++) {
-        BuddyBlock* current = free_lists[i];
-        while (current != nullptr) {
-            BuddyBlock* next = current->next;
-            delete current;
-            current = next;
-        }
-    }
 }
 
 // Allocate memory - returns block_id
@@ -221,13 +256,13 @@ int  BuddyAllocator::allocate(size_t requested_size) {
     total_allocations++;
     
     if (requested_size == 0) {
-        cout << "Error: Cannot allocate 0 bytes\n";
+        if (sink) sink->emit(SimEvent(SimEventType::ALLOC_ZERO_SIZE));
         failed_allocations++;
         return -1;
     }
     
     if (requested_size > total_memory) {
-        cout << "Error: Requested size exceeds total memory\n";
+        if (sink) sink->emit(SimEvent(SimEventType::BUDDY_TOO_LARGE, requested_size));
         failed_allocations++;
         return -1;
     }
@@ -236,15 +271,15 @@ int  BuddyAllocator::allocate(size_t requested_size) {
     size_t actual_size = nextPowerOfTwo(requested_size);
     int order = getOrder(actual_size);
     
-    cout << "\nAllocation request #" << total_allocations << ":\n";
-    cout << "  Requested: " << requested_size << " bytes\n";
-    cout << "  Rounded to: " << actual_size << " bytes (order " << order << ")\n";
+    if (sink) {
+        sink->emit(SimEvent(SimEventType::BUDDY_REQUEST, total_allocations, requested_size, actual_size, order));
+    }
     
     // Ensure we have a block of this size
     if (free_lists[order] == nullptr) {
-        cout << "  No free block at order " << order << ", splitting larger blocks...\n";
+        if (sink) sink->emit(SimEvent(SimEventType::BUDDY_SPLIT, order));
         if (!splitBlock(order)) {
-            cout << "  ERROR: Out of memory (cannot split)\n";
+            if (sink) sink->emit(SimEvent(SimEventType::BUDDY_SPLIT_FAILED));
             failed_allocations++;
             return -1;
         }
@@ -252,14 +287,13 @@ int  BuddyAllocator::allocate(size_t requested_size) {
     
     // Check if split succeeded
     if (free_lists[order] == nullptr) {
-        cout << "  ERROR: Out of memory\n";
+        if (sink) sink->emit(SimEvent(SimEventType::BUDDY_OUT_OF_MEMORY));
         failed_allocations++;
         return -1;
     }
     
     // Allocate block
-    BuddyBlock* block = free_lists[order];
-    free_lists[order] = block->next;
+    BuddyBlock* block = popFreeBlock(order);
     block->is_free = false;
     
     int block_id = next_block_id++;
@@ -277,42 +311,41 @@ int  BuddyAllocator::allocate(size_t requested_size) {
     record.requested_size = requested_size;
     record.actual_size = actual_size;
     record.order = order;
-    allocated_blocks[block_id] = record;
-    
-    cout << "  SUCCESS: Allocated block_id=" << block_id;
-    cout << " at address 0x" << hex << block->address << dec;
-    cout << " (size=" << actual_size << " bytes)\n";
+    if ((size_t)block_id >= allocated_blocks.size()) {
+        allocated_blocks.resize(block_id + 1);
+    }
+    AllocationSlot& slot = allocated_blocks[block_id];
+    slot.record = record;
+    slot.generation++;
+    live_blocks++;
     
-    if (internal_frag > 0) {
-        cout << "  Internal fragmentation: " << internal_frag << " bytes";
-        double frag_percent = (double)internal_frag / actual_size * 100.0;
-        cout << " (" << fixed << setprecision(2) << frag_percent << "%)\n";
+    if (sink) {
+        sink->emit(SimEvent(SimEventType::BUDDY_ALLOC_SUCCESS, block_id, block->address, actual_size, internal_frag));
     }
     
-    delete block;  // We don't need the block structure anymore
+    block_pool.release(block);  // We don't need the block structure anymore
     
     return block_id;
 }
 
 // Deallocate memory by block_id
 bool  BuddyAllocator::deallocate(int block_id) {
-    auto it = allocated_blocks.find(block_id);
-    if (it == allocated_blocks.end()) {
-        cout << "\nError: Invalid block_id " << block_id << "\n";
+    if (block_id <= 0 || (size_t)block_id >= allocated_blocks.size() ||
+        !allocated_blocks[block_id].isLive()) {
+        if (sink) sink->emit(SimEvent(SimEventType::BUDDY_FREE_INVALID, (uint64_t)(int64_t)block_id));
         return false;
     }
     
-    AllocationRecord& record = it->second;
+    AllocationSlot& slot = allocated_blocks[block_id];
+    AllocationRecord& record = slot.record;
     
-    cout << "\nDeallocation:\n";
-    cout << "  Block ID: " << block_id << "\n";
-    cout << "  Address: 0x" << hex << record.address << dec << "\n";
-    cout << "  Size: " << record.actual_size << " bytes (order " << record.order << ")\n";
+    if (sink) {
+        sink->emit(SimEvent(SimEventType::BUDDY_FREE, block_id, record.address, record.actual_size, record.order));
+    }
     
-    // Add block back to free list
-    BuddyBlock* block = new BuddyBlock(record.address, record.actual_size);
-    block->next = free_lists[record.order];
-    free_lists[record.order] = block;
+    // Block goes back on a free list once merging is done
+    BuddyBlock* block = block_pool.acquire(record.address, record.actual_size);
+    int order = record.order;
     
     total_deallocations++;
     
@@ -321,22 +354,28 @@ bool  BuddyAllocator::deallocate(int block_id) {
     total_internal_fragmentation -= internal_frag;
     
     // Remove from allocated blocks
-    allocated_blocks.erase(it);
+    slot.generation++;
+    live_blocks--;
     
     // Try to merge with buddy
-    cout << "  Attempting to merge with buddy...\n";
     int merges_before = merges;
-    mergeBlocks(record.address, record.order);
-    int merges_done = merges - merges_before;
-    if (merges_done > 0) {
-        cout << "  Performed " << merges_done << " merge(s)\n";
-    } else {
-        cout << "  No merge possible (buddy not free)\n";
-    }
+    mergeBlocks(block, order);
+    if (sink) sink->emit(SimEvent(SimEventType::BUDDY_MERGED, merges - merges_before));
     
     return true;
 }
 
+// Attach an event sink (nullptr or a NullEventSink disables reporting)
+void  BuddyAllocator::setEventSink(EventSink* event_sink) {
+    sink = activeSink(event_sink);
+}
+
+// Generation of a block_id's slot (odd while allocated, 0 if never used)
+uint32_t  BuddyAllocator::getBlockGeneration(int block_id) const {
+    if (block_id <= 0 || (size_t)block_id >= allocated_blocks.size()) return 0;
+    return allocated_blocks[block_id].generation;
+}
+
 // Display free lists
 void  BuddyAllocator::displayFreeLists() const {
     cout << "\n=== FREE LISTS ===\n";
@@ -378,18 +417,19 @@ void  BuddyAllocator::displayFreeLists() const {
 void  BuddyAllocator::displayAllocatedBlocks() const {
     cout << "\n=== ALLOCATED BLOCKS ===\n";
     
-    if (allocated_blocks.empty()) {
+    if (live_blocks == 0) {
         cout << "No blocks currently allocated\n";
         return;
     }
     
     cout << "Format: block_id | address | requested -> actual | internal_frag\n\n";
     
-    for (const auto& pair : allocated_blocks) {
-        const AllocationRecord& rec = pair.second;
+    for (size_t id = 0; id < allocated_blocks.size(); id++) {
+        if (!allocated_blocks[id].isLive()) continue;
+        const AllocationRecord& rec = allocated_blocks[id].record;
         size_t internal_frag = rec.actual_size - rec.requested_size;
         
-        cout << "Block " << setw(3) << pair.first;
+        cout << "Block " << setw(3) << id;
         cout << " | 0x" << hex << setfill('0') << setw(4) << rec.address << dec;
         cout << " | " << setw(5) << rec.requested_size << " -> " << setw(5) << rec.actual_size;
         cout << " | " << setw(4) << internal_frag << " bytes";
@@ -424,7 +464,7 @@ void  BuddyAllocator::displayStats() const {
     }
     
     cout << "  Total deallocations: " << total_deallocations << "\n";
-    cout << "  Currently allocated blocks: " << allocated_blocks.size() << "\n";
+    cout << "  Currently allocated blocks: " << live_blocks << "\n";
     
     // Split/Merge statistics
     cout << "\nSplit/Merge Operations:\n";
@@ -8,77 +8,410 @@
 #include <string>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include "cache_simulator.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
+// ==================== TAG MATCHING ====================
+
+// Ways per SIMD compare; each set's tag row is padded to a multiple of this
+#if defined(__AVX2__)
+static const int TAG_LANES = 4;
+#elif defined(__SSE2__)
+static const int TAG_LANES = 2;
+#else
+static const int TAG_LANES = 1;
+#endif
+
+// Helper: Bitmask of the (up to 64) tags in row[0..count) equal to tag.
+// count must be a multiple of TAG_LANES.
+static uint64_t matchTags(const uint64_t* row, int count, uint64_t tag) {
+    uint64_t mask = 0;
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi64x((long long)tag);
+    for (int i = 0; i < count; i += 4) {
+        __m256i lanes = _mm256_loadu_si256((const __m256i*)(row + i));
+        __m256i eq = _mm256_cmpeq_epi64(lanes, needle);
+        mask |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(eq)) << i;
+    }
+#elif defined(__SSE2__)
+    // No 64-bit compare in SSE2: both 32-bit halves must match
+    __m128i needle = _mm_set1_epi64x((long long)tag);
+    for (int i = 0; i < count; i += 2) {
+        __m128i lanes = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i eq = _mm_cmpeq_epi32(lanes, needle);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        mask |= (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(eq)) << i;
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        mask |= (uint64_t)(row[i] == tag) << i;
+    }
+#endif
+    return mask;
+}
+
+// Fully associative caches at least this wide use the tag hash index;
+// narrower ones are covered by a single SIMD row compare
+static const int TAG_INDEX_MIN_WAYS = 32;
+
+// RRIP re-reference prediction values (2 bits): 0 = near, 3 = distant
+static const uint8_t RRPV_MAX = 3;
+static const uint8_t RRPV_LONG = 2;
+
+// BRRIP inserts one fill in this many at RRPV_LONG, the rest at RRPV_MAX
+static const uint64_t BRRIP_LONG_INTERVAL = 32;
+
+// Helper: Packed recency order with way i at position i
+static uint64_t initialPermutation(int ways) {
+    uint64_t perm = 0;
+    for (int way = 0; way < ways; way++) {
+        perm |= (uint64_t)way << (4 * way);
+    }
+    return perm;
+}
+
 // ==================== CACHE CLASS IMPLEMENTATION ====================
     
+// Helper: log2 of a power of two, -1 otherwise
+static int exactLog2(size_t n) {
+    if (n == 0 || (n & (n - 1)) != 0) return -1;
+    return __builtin_ctzll(n);
+}
+    
 // Helper: Extract set index from address
-int Cache::getSetIndex(size_t address) {
+int Cache::getSetIndex(size_t address) const {
+    if (pow2_geometry) return (int)((address >> block_shift) & set_mask);
     size_t block_number = address / block_size;
     return block_number % num_sets;
 }
     
 // Helper: Extract tag from address
-size_t Cache::getTag(size_t address) {
+size_t Cache::getTag(size_t address) const {
+    if (pow2_geometry) return address >> tag_shift;
     size_t block_number = address / block_size;
     return block_number / num_sets;
 }
+
+// Helper: Read one way's bit from a per-set bitmask
+bool Cache::testBit(const vector<uint64_t>& bits, int set_index, int way) const {
+    return (bits[(size_t)set_index * mask_words + way / 64] >> (way % 64)) & 1;
+}
+
+// Helper: Set or clear one way's bit in a per-set bitmask
+void Cache::setBit(vector<uint64_t>& bits, int set_index, int way, bool value) {
+    uint64_t& word = bits[(size_t)set_index * mask_words + way / 64];
+    uint64_t bit = (uint64_t)1 << (way % 64);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+// Helper: Way holding tag in a set (-1 if absent). Compares 64 ways per
+// bitmask word with SIMD, then masks with the valid bits.
+int Cache::findWay(int set_index, uint64_t tag) const {
+    if (use_tag_index) {
+        auto it = tag_index.find(tag);
+        return (it == tag_index.end()) ? -1 : it->second;
+    }
     
-// Helper: Find victim in a set
-int Cache::findVictimInSet(int set_index) {
-    // First, check for invalid (empty) slot
-    for (int way = 0; way < ways; way++) {
-        if (!cache[set_index][way].valid) {
-            return way;
+    const uint64_t* row = &tags[lineIndex(set_index, 0)];
+    const uint64_t* valid = &valid_bits[(size_t)set_index * mask_words];
+    
+    for (int word = 0; word < mask_words; word++) {
+        int base = word * 64;
+        int count = min(64, way_stride - base);
+        uint64_t hits_mask = matchTags(row + base, count, tag) & valid[word];
+        if (hits_mask != 0) {
+            return base + __builtin_ctzll(hits_mask);
         }
     }
-        
-    // All ways full, find victim based on policy
-    if (replacement_policy == ReplacementPolicy::FIFO) {
-        return findFIFOVictimInSet(set_index);
+    return -1;
+}
+    
+// Helper: Insert a way at the head of its set's recency list (linked sets)
+void Cache::linkFront(int set_index, int way) {
+    size_t line = lineIndex(set_index, way);
+    int head = order_head[set_index];
+    order_prev[line] = -1;
+    order_next[line] = head;
+    if (head != -1) {
+        order_prev[lineIndex(set_index, head)] = way;
     } else {
-        return findLRUVictimInSet(set_index);
+        order_tail[set_index] = way;
     }
+    order_head[set_index] = way;
 }
-    
-// FIFO: Find oldest entry in set
-int Cache::findFIFOVictimInSet(int set_index) {
-    int oldest_way = 0;
-    int oldest_order = cache[set_index][0].insertion_order;
+
+// Helper: Remove a way from its set's recency list (linked sets)
+void Cache::unlinkWay(int set_index, int way) {
+    size_t line = lineIndex(set_index, way);
+    int prev = order_prev[line];
+    int next = order_next[line];
+    if (prev != -1) order_next[lineIndex(set_index, prev)] = next;
+    else order_head[set_index] = next;
+    if (next != -1) order_prev[lineIndex(set_index, next)] = prev;
+    else order_tail[set_index] = prev;
+}
+
+// Helper: Make a valid way the most recent in its set
+void Cache::moveToFront(int set_index, int way) {
+    if (packed_order) {
+        // Locate the way's nibble without a loop: XOR leaves a zero nibble
+        // at its position, and the lowest flagged zero nibble is exact
+        const uint64_t ones = 0x1111111111111111ULL;
+        uint64_t perm = order_perm[set_index];
+        uint64_t x = perm ^ (ones * (uint64_t)way);
+        uint64_t zero_nibbles = (x - ones) & ~x & (ones << 3);
+        int shift = __builtin_ctzll(zero_nibbles) - 3;   // 4 * position
         
-    for (int way = 1; way < ways; way++) {
-        if (cache[set_index][way].insertion_order < oldest_order) {
-            oldest_order = cache[set_index][way].insertion_order;
-            oldest_way = way;
+        // Shift positions [0, position) back by one and put the way first
+        uint64_t below = (shift == 0) ? 0 : (perm & ((~0ULL) >> (64 - shift)));
+        uint64_t above = (shift >= 60) ? 0 : (perm & ((~0ULL) << (shift + 4)));
+        order_perm[set_index] = above | (below << 4) | (uint64_t)way;
+    } else if (order_head[set_index] != way) {
+        unlinkWay(set_index, way);
+        linkFront(set_index, way);
+    }
+}
+
+// Helper: Point every tree node on the way's path away from it
+void Cache::touchPlruTree(int set_index, int way) {
+    uint64_t* bits = &plru_bits[(size_t)set_index * plru_words];
+    int node = plru_leaves + way;
+    while (node > 1) {
+        int parent = node >> 1;
+        uint64_t bit = (uint64_t)1 << (parent % 64);
+        // Left child touched: victim search goes right, and vice versa
+        if ((node & 1) == 0) bits[parent / 64] |= bit;
+        else bits[parent / 64] &= ~bit;
+        node = parent;
+    }
+}
+
+// Helper: Set the way's MRU bit; once all are set, keep only this one
+void Cache::touchPlruBits(int set_index, int way) {
+    uint64_t* bits = &plru_bits[(size_t)set_index * plru_words];
+    bits[way / 64] |= (uint64_t)1 << (way % 64);
+    
+    for (int word = 0; word < plru_words; word++) {
+        uint64_t full = (word == plru_words - 1 && ways % 64 != 0)
+                        ? ((uint64_t)1 << (ways % 64)) - 1 : ~0ULL;
+        if (bits[word] != full) return;
+    }
+    fill(bits, bits + plru_words, 0);
+    bits[way / 64] = (uint64_t)1 << (way % 64);
+}
+
+// Helper: Follow the tree bits to a leaf, skipping padding leaves
+int Cache::plruTreeVictim(int set_index) const {
+    const uint64_t* bits = &plru_bits[(size_t)set_index * plru_words];
+    int node = 1;
+    int first_way = 0;
+    int span = plru_leaves;
+    while (node < plru_leaves) {
+        span >>= 1;
+        int right = (bits[node / 64] >> (node % 64)) & 1;
+        if (right && first_way + span >= ways) right = 0;
+        node = 2 * node + right;
+        if (right) first_way += span;
+    }
+    return first_way;
+}
+
+// Helper: Lowest way whose MRU bit is clear
+int Cache::plruBitsVictim(int set_index) const {
+    const uint64_t* bits = &plru_bits[(size_t)set_index * plru_words];
+    for (int word = 0; word < plru_words; word++) {
+        if (~bits[word] != 0) {
+            int way = word * 64 + __builtin_ctzll(~bits[word]);
+            if (way < ways) return way;
         }
     }
-        
-    return oldest_way;
+    return 0;
 }
+
+// Helper: Lowest way predicted "distant", ageing the set until one is
+int Cache::rripVictim(int set_index) {
+    uint8_t* values = &rrpv[lineIndex(set_index, 0)];
+    uint8_t oldest = *max_element(values, values + ways);
+    if (oldest < RRPV_MAX) {
+        uint8_t age = RRPV_MAX - oldest;
+        for (int way = 0; way < ways; way++) values[way] += age;
+    }
+    return (int)(find(values, values + ways, RRPV_MAX) - values);
+}
+
+// Helper: Next value of the RANDOM policy's splitmix64 sequence
+uint64_t Cache::nextRandom() {
+    uint64_t z = (random_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Helper: Record a hit (FIFO order only changes on fills)
+void Cache::touchWay(int set_index, int way) {
+    switch (replacement_policy) {
+        case ReplacementPolicy::LRU:
+            moveToFront(set_index, way);
+            break;
+        case ReplacementPolicy::TREE_PLRU:
+            touchPlruTree(set_index, way);
+            break;
+        case ReplacementPolicy::BIT_PLRU:
+            touchPlruBits(set_index, way);
+            break;
+        case ReplacementPolicy::SRRIP:
+        case ReplacementPolicy::BRRIP:
+            rrpv[lineIndex(set_index, way)] = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+// Helper: Reset replacement state of every set to "all ways empty"
+void Cache::resetPolicyState() {
+    if (packed_order) {
+        fill(order_perm.begin(), order_perm.end(), initialPermutation(ways));
+    } else if (tracks_order) {
+        fill(order_head.begin(), order_head.end(), -1);
+        fill(order_tail.begin(), order_tail.end(), -1);
+        fill(lines_used.begin(), lines_used.end(), 0);
+    }
+    fill(plru_bits.begin(), plru_bits.end(), 0);
+    fill(rrpv.begin(), rrpv.end(), RRPV_MAX);
+    rrip_fills = 0;
+    random_state = random_seed;
+}
+
+// Helper: First byte address of the block held under tag in a set
+size_t Cache::blockAddress(int set_index, uint64_t tag) const {
+    if (pow2_geometry) return (tag << tag_shift) | ((size_t)set_index << block_shift);
+    return (tag * num_sets + set_index) * (size_t)block_size;
+}
+
+// Helper: Place a new line in a way, writing back a dirty victim.
+// Returns the displaced line, if any.
+CacheVictim Cache::fillLine(int set_index, int way, uint64_t tag, bool dirty, uint64_t access_time) {
+    size_t line = lineIndex(set_index, way);
+    bool was_valid = testBit(valid_bits, set_index, way);
+    
+    CacheVictim victim;
+    if (was_valid) {
+        victim.valid = true;
+        victim.address = blockAddress(set_index, tags[line]);
+        victim.dirty = testBit(dirty_bits, set_index, way);
+    }
     
-// LRU: Find least recently used entry in set
-int Cache::findLRUVictimInSet(int set_index) {
-    int lru_way = 0;
-    int lru_time = cache[set_index][0].last_access_time;
-        
-    for (int way = 1; way < ways; way++) {
-        if (cache[set_index][way].last_access_time < lru_time) {
-            lru_time = cache[set_index][way].last_access_time;
-            lru_way = way;
+    // If evicting a dirty line (write-back only), need to write back
+    if (victim.dirty && write_policy == WritePolicy::WRITE_BACK) {
+        writebacks++;
+    }
+    
+    if (use_tag_index) {
+        if (was_valid) tag_index.erase(tags[line]);
+        tag_index[tag] = way;
+    }
+    
+    if (!prefetch_bits.empty()) {
+        if (was_valid && testBit(prefetch_bits, set_index, way)) prefetch_useless++;
+        setBit(prefetch_bits, set_index, way, false);
+    }
+    
+    if (tracks_order) {
+        if (packed_order || was_valid) {
+            moveToFront(set_index, way);
+        } else {
+            linkFront(set_index, way);
+            lines_used[set_index]++;
         }
+    } else if (replacement_policy == ReplacementPolicy::SRRIP) {
+        rrpv[line] = RRPV_LONG;
+    } else if (replacement_policy == ReplacementPolicy::BRRIP) {
+        rrpv[line] = (++rrip_fills % BRRIP_LONG_INTERVAL == 0) ? RRPV_LONG : RRPV_MAX;
+    } else {
+        touchWay(set_index, way);
+    }
+    
+    setBit(valid_bits, set_index, way, true);
+    setBit(dirty_bits, set_index, way, dirty);
+    tags[line] = tag;
+    insertion_order[line] = next_insertion_order++;
+    last_access_time[line] = access_time;
+    return victim;
+}
+    
+// Helper: Count a demand hit on a prefetched line as useful (first use only)
+void Cache::notePrefetchHit(int set_index, int way) {
+    if (prefetch_bits.empty() || !testBit(prefetch_bits, set_index, way)) return;
+    setBit(prefetch_bits, set_index, way, false);
+    prefetch_useful++;
+    last_hit_prefetched = true;
+    last_hit_ready = prefetch_ready[lineIndex(set_index, way)];
+}
+    
+// Helper: Lowest invalid way of a set (-1 if the set is full)
+int Cache::firstEmptyWay(int set_index) const {
+    const uint64_t* valid = &valid_bits[(size_t)set_index * mask_words];
+    for (int word = 0; word < mask_words; word++) {
+        uint64_t empty = ~valid[word];
+        if (word == mask_words - 1 && ways % 64 != 0) {
+            empty &= ((uint64_t)1 << (ways % 64)) - 1;
+        }
+        if (empty != 0) {
+            return word * 64 + __builtin_ctzll(empty);
+        }
+    }
+    return -1;
+}
+    
+// Helper: Find victim in a set - the lowest empty way, else the policy's choice
+int Cache::findVictimInSet(int set_index) {
+    if (packed_order) {
+        uint64_t full = ((uint64_t)1 << ways) - 1;
+        uint64_t empty = ~valid_bits[set_index] & full;
+        if (empty != 0) return __builtin_ctzll(empty);
+        return (int)((order_perm[set_index] >> (4 * (ways - 1))) & 0xF);
+    }
+    
+    if (tracks_order && lines_used[set_index] == ways) {
+        return order_tail[set_index];
+    }
+    
+    int empty_way = firstEmptyWay(set_index);
+    if (empty_way != -1) return empty_way;
+    
+    switch (replacement_policy) {
+        case ReplacementPolicy::TREE_PLRU:
+            return plruTreeVictim(set_index);
+        case ReplacementPolicy::BIT_PLRU:
+            return plruBitsVictim(set_index);
+        case ReplacementPolicy::SRRIP:
+        case ReplacementPolicy::BRRIP:
+            return rripVictim(set_index);
+        case ReplacementPolicy::RANDOM:
+            return (int)(nextRandom() % (uint64_t)ways);
+        default:
+            return order_tail[set_index];
     }
-        
-    return lru_way;
 }
     
 
 // Constructor
-Cache::Cache(string cache_name, int total_lines, int blk_size, 
-             AssociativityType assoc, ReplacementPolicy repl_pol, WritePolicy wr_pol) 
-    : name(cache_name), capacity(total_lines), block_size(blk_size),
-      associativity(assoc), replacement_policy(repl_pol), write_policy(wr_pol),
+Cache::Cache(string cache_name, const CacheLevelConfig& config)
+    : name(cache_name), capacity(config.lines), block_size(config.block_size),
+      associativity(config.associativity), replacement_policy(config.replacement),
+      write_policy(config.write_policy),
+      rrip_fills(0), random_seed(config.random_seed), random_state(config.random_seed),
+      last_hit_prefetched(false), last_hit_ready(0), prefetch_fills(0), prefetch_useful(0),
+      prefetch_late(0), prefetch_useless(0),
       next_insertion_order(0), access_counter(0), 
       hits(0), misses(0), writes(0), write_hits(0), write_misses(0), writebacks(0) {
     
@@ -96,39 +429,91 @@ Cache::Cache(string cache_name, int total_lines, int blk_size,
             ways = 4;
             num_sets = capacity / 4;
             break;
+        case AssociativityType::N_WAY:
+            ways = max(1, min(config.ways, capacity));
+            num_sets = capacity / ways;
+            break;
         case AssociativityType::FULLY_ASSOCIATIVE:
             ways = capacity;
             num_sets = 1;
             break;
     }
     
-    // Initialize cache structure: cache[set][way]
-    cache.resize(num_sets);
-    for (int i = 0; i < num_sets; i++) {
-        cache[i].resize(ways);
+    // Shift/mask index and tag extraction when the geometry allows it
+    int block_log2 = exactLog2(block_size);
+    int sets_log2 = exactLog2(num_sets);
+    pow2_geometry = (block_log2 >= 0 && sets_log2 >= 0);
+    block_shift = pow2_geometry ? block_log2 : 0;
+    tag_shift = pow2_geometry ? block_log2 + sets_log2 : 0;
+    set_mask = pow2_geometry ? (size_t)num_sets - 1 : 0;
+    
+    // Flat storage; padding ways are never valid so they never match
+    way_stride = (ways + TAG_LANES - 1) / TAG_LANES * TAG_LANES;
+    mask_words = (ways + 63) / 64;
+    size_t num_entries = (size_t)num_sets * way_stride;
+    tags.assign(num_entries, 0);
+    insertion_order.assign(num_entries, 0);
+    last_access_time.assign(num_entries, 0);
+    valid_bits.assign((size_t)num_sets * mask_words, 0);
+    dirty_bits.assign((size_t)num_sets * mask_words, 0);
+    
+    tracks_order = (replacement_policy == ReplacementPolicy::FIFO ||
+                    replacement_policy == ReplacementPolicy::LRU);
+    packed_order = tracks_order && (ways <= 16);
+    if (packed_order) {
+        order_perm.assign(num_sets, initialPermutation(ways));
+    } else if (tracks_order) {
+        order_prev.assign(num_entries, -1);
+        order_next.assign(num_entries, -1);
+        order_head.assign(num_sets, -1);
+        order_tail.assign(num_sets, -1);
+        lines_used.assign(num_sets, 0);
+    }
+    
+    // Tree-PLRU nodes are heap-numbered from 1 over a power-of-two leaf count
+    plru_leaves = 1;
+    while (plru_leaves < ways) plru_leaves <<= 1;
+    plru_words = 0;
+    if (replacement_policy == ReplacementPolicy::TREE_PLRU) {
+        plru_words = (plru_leaves + 63) / 64;
+    } else if (replacement_policy == ReplacementPolicy::BIT_PLRU) {
+        plru_words = mask_words;
+    }
+    plru_bits.assign((size_t)num_sets * plru_words, 0);
+    
+    if (replacement_policy == ReplacementPolicy::SRRIP ||
+        replacement_policy == ReplacementPolicy::BRRIP) {
+        rrpv.assign(num_entries, RRPV_MAX);
+    }
+    
+    use_tag_index = (associativity == AssociativityType::FULLY_ASSOCIATIVE && ways >= TAG_INDEX_MIN_WAYS);
+    if (use_tag_index) {
+        tag_index.reserve(ways);
     }
 }
 
 // Read operation - returns true if HIT, false if MISS
 bool Cache::read(size_t address) {
     access_counter++;
+    last_hit_prefetched = false;
     
     int set_index = getSetIndex(address);
     size_t tag = getTag(address);
     
     // Check if tag is in this set (search for hit)
-    for (int way = 0; way < ways; way++) {
-        if (cache[set_index][way].valid && cache[set_index][way].tag == tag) {
-            // Cache HIT!
-            hits++;
-            
-            // Update access time for LRU
-            if (replacement_policy == ReplacementPolicy::LRU) {
-                cache[set_index][way].last_access_time = access_counter;
-            }
-            
-            return true;
+    int way = findWay(set_index, tag);
+    if (way != -1) {
+        // Cache HIT!
+        hits++;
+        notePrefetchHit(set_index, way);
+        
+        // Update access time for LRU; every policy but FIFO tracks hits
+        if (replacement_policy == ReplacementPolicy::LRU) {
+            last_access_time[lineIndex(set_index, way)] = access_counter;
         }
+        touchWay(set_index, way);
+        
+        return true;
     }
     
     // Cache MISS
@@ -136,35 +521,38 @@ bool Cache::read(size_t address) {
     return false;
 }
 
-// Write operation - returns true if HIT, false if MISS
-bool Cache::write(size_t address) {
+// Write operation - returns true if HIT, false if MISS. A miss
+// allocates the block; the line it displaces is stored in victim.
+bool Cache::write(size_t address, CacheVictim* victim) {
     access_counter++;
     writes++;
+    last_hit_prefetched = false;
     
     int set_index = getSetIndex(address);
     size_t tag = getTag(address);
     
     // Check if tag is in this set (search for hit)
-    for (int way = 0; way < ways; way++) {
-        if (cache[set_index][way].valid && cache[set_index][way].tag == tag) {
-            // Write HIT!
-            write_hits++;
-            hits++;
-            
-            // Update access time for LRU
-            if (replacement_policy == ReplacementPolicy::LRU) {
-                cache[set_index][way].last_access_time = access_counter;
-            }
-            
-            // Handle write policy
-            if (write_policy == WritePolicy::WRITE_BACK) {
-                // Mark as dirty (will write to memory on eviction)
-                cache[set_index][way].dirty = true;
-            }
-            // For WRITE_THROUGH, write happens to memory immediately (handled by hierarchy)
-            
-            return true;
+    int way = findWay(set_index, tag);
+    if (way != -1) {
+        // Write HIT!
+        write_hits++;
+        hits++;
+        notePrefetchHit(set_index, way);
+        
+        // Update access time for LRU; every policy but FIFO tracks hits
+        if (replacement_policy == ReplacementPolicy::LRU) {
+            last_access_time[lineIndex(set_index, way)] = access_counter;
         }
+        touchWay(set_index, way);
+        
+        // Handle write policy
+        if (write_policy == WritePolicy::WRITE_BACK) {
+            // Mark as dirty (will write to memory on eviction)
+            setBit(dirty_bits, set_index, way, true);
+        }
+        // For WRITE_THROUGH, write happens to memory immediately (handled by hierarchy)
+        
+        return true;
     }
     
     // Write MISS
@@ -175,31 +563,15 @@ bool Cache::write(size_t address) {
     // (This is standard behavior for most caches)
     int victim_way = findVictimInSet(set_index);
     
-    // If evicting a dirty line (write-back only), need to write back
-    if (cache[set_index][victim_way].valid && 
-        cache[set_index][victim_way].dirty &&
-        write_policy == WritePolicy::WRITE_BACK) {
-        writebacks++;
-    }
-    
-    // Insert new entry
-    cache[set_index][victim_way].valid = true;
-    cache[set_index][victim_way].tag = tag;
-    cache[set_index][victim_way].insertion_order = next_insertion_order++;
-    cache[set_index][victim_way].last_access_time = access_counter;
-    
-    // Set dirty bit based on write policy
-    if (write_policy == WritePolicy::WRITE_BACK) {
-        cache[set_index][victim_way].dirty = true;  // Dirty immediately
-    } else {
-        cache[set_index][victim_way].dirty = false; // Clean (written through)
-    }
+    // Insert new entry; dirty immediately for write-back, clean (written through) otherwise
+    CacheVictim displaced = fillLine(set_index, victim_way, tag, write_policy == WritePolicy::WRITE_BACK, access_counter);
+    if (victim != nullptr) *victim = displaced;
     
     return false;
 }
 
-// Insert (for hierarchy updates)
-void Cache::insert(size_t address, bool is_dirty) {
+// Insert (for hierarchy updates); returns the line it displaced, if any
+CacheVictim Cache::insert(size_t address, bool is_dirty) {
     int set_index = getSetIndex(address);
     size_t tag = getTag(address);
     
@@ -208,60 +580,107 @@ void Cache::insert(size_t address, bool is_dirty) {
     bool actual_dirty = (write_policy == WritePolicy::WRITE_BACK) ? is_dirty : false;
     
     // Check if already present
-    for (int way = 0; way < ways; way++) {
-        if (cache[set_index][way].valid && cache[set_index][way].tag == tag) {
-            // Update access time for LRU
-            if (replacement_policy == ReplacementPolicy::LRU) {
-                cache[set_index][way].last_access_time = ++access_counter;
-            }
-            // Update dirty bit if needed (only for write-back)
-            if (actual_dirty) {
-                cache[set_index][way].dirty = true;
-            }
-            return;
+    int way = findWay(set_index, tag);
+    if (way != -1) {
+        // Update access time for LRU. A refill is not a re-reference, so
+        // RRIP keeps the line's insertion prediction.
+        if (replacement_policy == ReplacementPolicy::LRU) {
+            last_access_time[lineIndex(set_index, way)] = ++access_counter;
         }
+        if (rrpv.empty()) touchWay(set_index, way);
+        // Update dirty bit if needed (only for write-back)
+        if (actual_dirty) {
+            setBit(dirty_bits, set_index, way, true);
+        }
+        return CacheVictim();
     }
     
     // Not present, insert
     int victim_way = findVictimInSet(set_index);
-    
-    // Check if evicting dirty line
-    if (cache[set_index][victim_way].valid && 
-        cache[set_index][victim_way].dirty &&
-        write_policy == WritePolicy::WRITE_BACK) {
+    return fillLine(set_index, victim_way, tag, actual_dirty, ++access_counter);
+}
+
+// Evict and return if dirty (counts a write-back for dirty write-back lines)
+bool Cache::evict(size_t address, bool& was_dirty) {
+    if (!invalidate(address, was_dirty)) return false;
+    if (was_dirty && write_policy == WritePolicy::WRITE_BACK) {
         writebacks++;
     }
-    
-    cache[set_index][victim_way].valid = true;
-    cache[set_index][victim_way].tag = tag;
-    cache[set_index][victim_way].dirty = actual_dirty;
-    cache[set_index][victim_way].insertion_order = next_insertion_order++;
-    cache[set_index][victim_way].last_access_time = ++access_counter;
+    return true;
 }
 
-// Evict and return if dirty
-bool Cache::evict(size_t address, bool& was_dirty) {
+// Remove a block without counting a write-back (the caller moves its data)
+bool Cache::invalidate(size_t address, bool& was_dirty) {
     int set_index = getSetIndex(address);
     size_t tag = getTag(address);
     
-    for (int way = 0; way < ways; way++) {
-        if (cache[set_index][way].valid && cache[set_index][way].tag == tag) {
-            was_dirty = cache[set_index][way].dirty;
-            cache[set_index][way].valid = false;
-            cache[set_index][way].dirty = false;
-            
-            if (was_dirty && write_policy == WritePolicy::WRITE_BACK) {
-                writebacks++;
-            }
-            
-            return true;
+    int way = findWay(set_index, tag);
+    if (way != -1) {
+        was_dirty = testBit(dirty_bits, set_index, way);
+        setBit(valid_bits, set_index, way, false);
+        setBit(dirty_bits, set_index, way, false);
+        if (!prefetch_bits.empty() && testBit(prefetch_bits, set_index, way)) {
+            setBit(prefetch_bits, set_index, way, false);
+            prefetch_useless++;
         }
+        if (use_tag_index) tag_index.erase(tag);
+        if (tracks_order && !packed_order) {
+            unlinkWay(set_index, way);
+            lines_used[set_index]--;
+        }
+        
+        return true;
     }
     
     was_dirty = false;
     return false;
 }
 
+// Lookup without touching statistics or replacement state
+bool Cache::contains(size_t address) const {
+    return findWay(getSetIndex(address), getTag(address)) != -1;
+}
+
+// Start tracking prefetched lines (called when a prefetcher is attached)
+void Cache::enablePrefetchTracking() {
+    if (!prefetch_bits.empty()) return;
+    prefetch_bits.assign(valid_bits.size(), 0);
+    prefetch_ready.assign(tags.size(), 0);
+}
+
+// Fill a prefetched block, arriving at ready_cycle; false if already present
+bool Cache::prefetch(size_t address, uint64_t ready_cycle, CacheVictim* victim) {
+    int set_index = getSetIndex(address);
+    size_t tag = getTag(address);
+    if (findWay(set_index, tag) != -1) return false;
+    
+    int victim_way = findVictimInSet(set_index);
+    CacheVictim displaced = fillLine(set_index, victim_way, tag, false, ++access_counter);
+    if (victim != nullptr) *victim = displaced;
+    setBit(prefetch_bits, set_index, victim_way, true);
+    prefetch_ready[lineIndex(set_index, victim_way)] = ready_cycle;
+    prefetch_fills++;
+    return true;
+}
+
+// Cycles the last demand hit still waits for its prefetched block
+uint64_t Cache::prefetchWait(uint64_t now) {
+    if (!last_hit_prefetched || last_hit_ready <= now) return 0;
+    prefetch_late++;
+    return last_hit_ready - now;
+}
+
+// Append the address of every resident block
+void Cache::residentBlocks(vector<size_t>& addresses) const {
+    for (int set = 0; set < num_sets; set++) {
+        for (int way = 0; way < ways; way++) {
+            if (testBit(valid_bits, set, way)) {
+                addresses.push_back(blockAddress(set, tags[lineIndex(set, way)]));
+            }
+        }
+    }
+}
+
 // Display cache statistics
 void Cache::displayStats() const {
     cout << name << " Statistics:\n";
@@ -278,12 +697,19 @@ void Cache::displayStats() const {
         case AssociativityType::FOUR_WAY:
             cout << "4-way set associative\n";
             break;
+        case AssociativityType::N_WAY:
+            cout << ways << "-way set associative\n";
+            break;
         case AssociativityType::FULLY_ASSOCIATIVE:
             cout << "Fully associative\n";
             break;
     }
     cout << "  Sets: " << num_sets << ", Ways: " << ways << "\n";
-    cout << "  Replacement Policy: " << (replacement_policy == ReplacementPolicy::FIFO ? "FIFO" : "LRU") << "\n";
+    cout << "  Replacement Policy: " << replacementPolicyName(replacement_policy);
+    if (replacement_policy == ReplacementPolicy::RANDOM) {
+        cout << " (seed " << random_seed << ")";
+    }
+    cout << "\n";
     cout << "  Write Policy: " << (write_policy == WritePolicy::WRITE_THROUGH ? "Write-Through" : "Write-Back") << "\n";
     cout << "  Hits: " << hits << "\n";
     cout << "  Misses: " << misses << "\n";
@@ -298,30 +724,43 @@ void Cache::displayStats() const {
     if (write_policy == WritePolicy::WRITE_BACK) {
         cout << "  Write-backs to memory: " << writebacks << "\n";
     }
+    
+    if (!prefetch_bits.empty()) {
+        cout << "  Prefetches: " << prefetch_fills << " (useful: " << prefetch_useful
+             << ", late: " << prefetch_late << ", useless: " << prefetch_useless << ")\n";
+        if (prefetch_fills > 0) {
+            cout << "  Prefetch accuracy: " << fixed << setprecision(2)
+                 << (double)prefetch_useful / prefetch_fills * 100.0 << "%\n";
+        }
+    }
 }
     
 // Get hit ratio
 double Cache::getHitRatio() const {
-    int total = hits + misses;
+    uint64_t total = hits + misses;
     if (total == 0) return 0.0;
     return ((double)hits / total) * 100.0;
 }
 
 // Get statistics
-int Cache::getHits() const { return hits; }
-int Cache::getMisses() const { return misses; }
-int Cache::getTotalAccesses() const { return hits + misses; }
-int Cache::getWritebacks() const { return writebacks; }
+uint64_t Cache::getHits() const { return hits; }
+uint64_t Cache::getMisses() const { return misses; }
+uint64_t Cache::getTotalAccesses() const { return hits + misses; }
+uint64_t Cache::getWritebacks() const { return writebacks; }
 WritePolicy Cache::getWritePolicy() const { return write_policy; }
     
 // Clear cache
 void Cache::clear() {
-    for (int set = 0; set < num_sets; set++) {
-        for (int way = 0; way < ways; way++) {
-            cache[set][way].valid = false;
-            cache[set][way].dirty = false;
-        }
-    }
+    fill(valid_bits.begin(), valid_bits.end(), 0);
+    fill(dirty_bits.begin(), dirty_bits.end(), 0);
+    tag_index.clear();
+    resetPolicyState();
+    fill(prefetch_bits.begin(), prefetch_bits.end(), 0);
+    last_hit_prefetched = false;
+    prefetch_fills = 0;
+    prefetch_useful = 0;
+    prefetch_late = 0;
+    prefetch_useless = 0;
     hits = 0;
     misses = 0;
     writes = 0;
@@ -339,12 +778,16 @@ void Cache::displayContents() const {
         cout << "  Set " << set << ":\n";
         for (int way = 0; way < ways; way++) {
             cout << "    Way " << way << ": ";
-            if (cache[set][way].valid) {
-                cout << "Tag=" << cache[set][way].tag 
-                     << (cache[set][way].dirty ? " [DIRTY]" : " [CLEAN]")
-                     << " (order=" << cache[set][way].insertion_order;
+            size_t line = lineIndex(set, way);
+            if (testBit(valid_bits, set, way)) {
+                cout << "Tag=" << tags[line] 
+                     << (testBit(dirty_bits, set, way) ? " [DIRTY]" : " [CLEAN]")
+                     << " (order=" << insertion_order[line];
                 if (replacement_policy == ReplacementPolicy::LRU) {
-                    cout << ", lru=" << cache[set][way].last_access_time;
+                    cout << ", lru=" << last_access_time[line];
+                }
+                if (!rrpv.empty()) {
+                    cout << ", rrpv=" << (int)rrpv[line];
                 }
                 cout << ")\n";
             } else {
@@ -357,27 +800,33 @@ void Cache::displayContents() const {
 // ==================== CACHE HIERARCHY ====================
 
 // Constructor
-CacheHierarchy::CacheHierarchy(
-    int l1_lines, int l1_block, AssociativityType l1_assoc, ReplacementPolicy l1_repl, WritePolicy l1_write,
-    int l2_lines, int l2_block, AssociativityType l2_assoc, ReplacementPolicy l2_repl, WritePolicy l2_write,
-    int l3_lines, int l3_block, AssociativityType l3_assoc, ReplacementPolicy l3_repl, WritePolicy l3_write)
+CacheHierarchy::CacheHierarchy(const CacheLevelConfig& l1_config,
+                               const CacheLevelConfig& l2_config,
+                               const CacheLevelConfig& l3_config,
+                               const CacheLatencyConfig& latency_config,
+                               InclusionPolicy inclusion_policy)
     : total_accesses(0), total_reads(0), total_writes(0),
       l1_hits(0), l2_hits(0), l3_hits(0), memory_accesses(0), memory_writes(0),
-      l1_penalty(1), l2_penalty(10), l3_penalty(50), memory_penalty(100), 
-      total_penalty_cycles(0) {
-    
-    l1 = new Cache("L1", l1_lines, l1_block, l1_assoc, l1_repl, l1_write);
-    
-    if (l2_lines > 0) {
-        l2 = new Cache("L2", l2_lines, l2_block, l2_assoc, l2_repl, l2_write);
+      memory_writebacks(0),
+      inclusion(inclusion_policy), back_invalidations(0), dirty_back_invalidations(0), victims_moved(0),
+      latency(latency_config), prefetchers{nullptr, nullptr, nullptr}, prefetch_memory_reads(0),
+      victim_cache(nullptr), victim_latency(1), victim_probes(0), victim_hits(0),
+      mshr_entries(0), mshr_window(0), mshr_merges(0), mshr_full_stalls(0), mshr_stall_cycles(0),
+      total_penalty_cycles(0), read_cycles(0), write_cycles(0),
+      level_cycles{0, 0, 0, 0}, sink(nullptr) {
+    
+    l1 = new Cache("L1", l1_config);
+    
+    if (l2_config.lines > 0) {
+        l2 = new Cache("L2", l2_config);
         has_l2 = true;
     } else {
         l2 = nullptr;
         has_l2 = false;
     }
     
-    if (l3_lines > 0) {
-        l3 = new Cache("L3", l3_lines, l3_block, l3_assoc, l3_repl, l3_write);
+    if (l3_config.lines > 0) {
+        l3 = new Cache("L3", l3_config);
         has_l3 = true;
     } else {
         l3 = nullptr;
@@ -394,218 +843,551 @@ CacheHierarchy::~CacheHierarchy() {
     delete l1;
     if (l2 != nullptr) delete l2;
     if (l3 != nullptr) delete l3;
+    delete victim_cache;
+    for (Prefetcher* prefetcher : prefetchers) {
+        delete prefetcher;
+    }
+}
+
+// Attach an event sink (nullptr or a NullEventSink disables reporting)
+void CacheHierarchy::setEventSink(EventSink* event_sink) {
+    sink = activeSink(event_sink);
+}
+
+// Attach a prefetcher to an existing level (1..3), replacing any previous one
+bool CacheHierarchy::setPrefetcher(int level, const PrefetchConfig& config) {
+    Cache* cache = (level >= 1 && level <= 3) ? levelCache(level - 1) : nullptr;
+    if (cache == nullptr) return false;
+    
+    delete prefetchers[level - 1];
+    prefetchers[level - 1] = new Prefetcher(config, cache->getBlockSize());
+    cache->enablePrefetchTracking();
+    return true;
+}
+
+// Detach a level's prefetcher (its prefetch statistics stay visible)
+void CacheHierarchy::removePrefetcher(int level) {
+    if (level < 1 || level > 3) return;
+    delete prefetchers[level - 1];
+    prefetchers[level - 1] = nullptr;
+}
+
+// Attach a victim cache behind L1 (0 entries removes it). Dirty lines
+// parked in a previous victim cache are written back first.
+bool CacheHierarchy::setVictimCache(int entries, int hit_latency) {
+    if (entries < 0 || hit_latency < 0) return false;
+    
+    if (victim_cache != nullptr) {
+        vector<size_t> parked;
+        victim_cache->residentBlocks(parked);
+        for (size_t address : parked) {
+            bool dirty = false;
+            victim_cache->invalidate(address, dirty);
+            if (dirty) writeBackBelow(0, address);
+        }
+        delete victim_cache;
+        victim_cache = nullptr;
+    }
+    if (entries == 0) return true;
+    
+    CacheLevelConfig config;
+    config.lines = entries;
+    config.block_size = l1->getBlockSize();
+    config.associativity = AssociativityType::FULLY_ASSOCIATIVE;
+    config.replacement = ReplacementPolicy::LRU;
+    config.write_policy = l1->getWritePolicy();
+    victim_cache = new Cache("Victim", config);
+    victim_latency = hit_latency;
+    return true;
+}
+
+// Model L1 miss-status holding registers (0 entries turns them off)
+void CacheHierarchy::setMshrs(int entries, uint64_t window) {
+    mshr_entries = max(0, entries);
+    mshr_window = window;
+    mshrs.clear();
+}
+
+// Sets, ways and block size of an existing level (1..3)
+bool CacheHierarchy::levelGeometry(int level, int& sets, int& ways, int& block_size) const {
+    const Cache* cache = (level >= 1 && level <= 3) ? levelCache(level - 1) : nullptr;
+    if (cache == nullptr) return false;
+    
+    sets = cache->getNumSets();
+    ways = cache->getWays();
+    block_size = cache->getBlockSize();
+    return true;
+}
+
+// Helper: Cache of a level index (0..2), nullptr if the level is absent
+Cache* CacheHierarchy::levelCache(int level) const {
+    if (level == 0) return l1;
+    if (level == 1) return l2;
+    return l3;
+}
+
+// Helper: Demand lookup at one level, driving the level's prefetcher
+bool CacheHierarchy::lookup(int level, size_t address, bool is_write, int& penalty) {
+    Cache* cache = levelCache(level);
+    bool hit;
+    
+    // Exclusive lower levels are probed without write-allocation; a hit
+    // moves the block up to L1
+    if (is_write && (level == 0 || inclusion != InclusionPolicy::EXCLUSIVE)) {
+        CacheVictim victim;
+        hit = cache->write(address, &victim);
+        handleVictim(level, victim);
+    } else {
+        hit = cache->read(address);
+    }
+    if (prefetchers[level] == nullptr) return hit;
+    
+    // A late prefetch costs the cycles until its block arrives
+    uint64_t now = total_penalty_cycles + penalty;
+    uint64_t wait = cache->prefetchWait(now);
+    if (wait > 0) chargeCycles(level, (int)wait, penalty);
+    
+    // Train on misses and on the first use of prefetched lines
+    if (!hit || cache->hitPrefetchedLine()) {
+        issuePrefetches(level, address, now);
+    }
+    return hit;
+}
+
+// Helper: Remove a block L1 is about to miss on from the victim cache;
+// true if it was there. Done before the L1 lookup so the line L1
+// displaces cannot push the block out of the victim cache first.
+bool CacheHierarchy::takeFromVictimCache(size_t address, bool& dirty) {
+    dirty = false;
+    if (victim_cache == nullptr || l1->contains(address)) return false;
+    
+    victim_probes++;
+    return victim_cache->invalidate(address, dirty);
+}
+
+// Helper: Give an L1 miss an MSHR; true if it merged with an outstanding
+// miss to the same block. With every MSHR busy the miss stalls until the
+// oldest one retires.
+bool CacheHierarchy::trackL1Miss(size_t address, int& penalty) {
+    if (mshr_entries == 0) return false;
+    
+    uint64_t now = total_penalty_cycles + penalty;
+    size_t block = address / l1->getBlockSize();
+    
+    auto retired = [&now](const MshrEntry& entry) { return entry.retire_cycle <= now; };
+    mshrs.erase(remove_if(mshrs.begin(), mshrs.end(), retired), mshrs.end());
+    
+    for (const MshrEntry& entry : mshrs) {
+        if (entry.block == block) {
+            mshr_merges++;
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_MSHR_MERGE, block * l1->getBlockSize()));
+            return true;
+        }
+    }
+    
+    if ((int)mshrs.size() >= mshr_entries) {
+        uint64_t oldest = mshrs[0].retire_cycle;
+        for (const MshrEntry& entry : mshrs) oldest = min(oldest, entry.retire_cycle);
+        
+        int stall = (int)(oldest - now);
+        mshr_full_stalls++;
+        mshr_stall_cycles += stall;
+        chargeCycles(0, stall, penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_MSHR_STALL, stall));
+        
+        now = oldest;
+        mshrs.erase(remove_if(mshrs.begin(), mshrs.end(), retired), mshrs.end());
+    }
+    
+    MshrEntry entry;
+    entry.block = block;
+    entry.retire_cycle = now + mshr_window;
+    mshrs.push_back(entry);
+    return false;
+}
+
+// Helper: Finish an L1 miss from the victim cache or a merged MSHR;
+// false if it has to go on to the next level. A merged miss shares the
+// outstanding fill, so it costs no cycles beyond the L1 miss.
+bool CacheHierarchy::serveL1Miss(size_t address, bool is_write, bool victim_hit,
+                                 bool victim_dirty, int& penalty) {
+    uint8_t flags = is_write ? EVENT_WRITE : 0;
+    
+    if (victim_hit) {
+        victim_hits++;
+        chargeCycles(0, victim_latency, penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_VICTIM_HIT, victim_latency, penalty, 0, 0, 1, flags));
+    } else if (!trackL1Miss(address, penalty)) {
+        return false;
+    }
+    
+    // Write misses have already allocated the line in L1
+    if (!is_write) {
+        fillLevel(0, address, victim_dirty);
+    } else if (l1->getWritePolicy() == WritePolicy::WRITE_THROUGH) {
+        memory_writes++;
+    }
+    return true;
+}
+
+// Helper: Fetch the prefetcher's candidates into its level. Each block
+// comes from the nearest lower level holding it, else from memory.
+void CacheHierarchy::issuePrefetches(int level, size_t address, uint64_t now) {
+    Cache* cache = levelCache(level);
+    uint64_t block_size = cache->getBlockSize();
+    
+    prefetch_candidates.clear();
+    prefetchers[level]->train(address / block_size, prefetch_candidates);
+    
+    for (uint64_t block : prefetch_candidates) {
+        size_t target = block * block_size;
+        if (cache->contains(target)) continue;
+        if (level == 0 && victim_cache != nullptr && victim_cache->contains(target)) continue;
+        if (inclusion == InclusionPolicy::EXCLUSIVE && cachedOutside(level, target)) continue;
+        
+        int fetch_latency = latency.memory;
+        bool from_memory = true;
+        for (int lower = level + 1; lower < 3; lower++) {
+            Cache* lower_cache = levelCache(lower);
+            if (lower_cache != nullptr && lower_cache->contains(target)) {
+                fetch_latency = latency.hit[lower];
+                from_memory = false;
+                break;
+            }
+        }
+        
+        CacheVictim victim;
+        cache->prefetch(target, now + fetch_latency, &victim);
+        handleVictim(level, victim);
+        if (from_memory) prefetch_memory_reads++;
+        
+        // Inclusive: every lower level must hold the block too
+        if (inclusion == InclusionPolicy::INCLUSIVE) {
+            for (int lower = 2; lower > level; lower--) {
+                Cache* lower_cache = levelCache(lower);
+                if (lower_cache != nullptr && !lower_cache->contains(target)) {
+                    fillLevel(lower, target, false);
+                }
+            }
+        }
+    }
+}
+
+// Helper: Whether a level other than the given one holds the block
+bool CacheHierarchy::cachedOutside(int level, size_t address) const {
+    for (int other = 0; other < 3; other++) {
+        Cache* cache = levelCache(other);
+        if (other != level && cache != nullptr && cache->contains(address)) return true;
+    }
+    return victim_cache != nullptr && victim_cache->contains(address);
+}
+
+// Helper: Insert a block into one level and deal with the line it displaces
+void CacheHierarchy::fillLevel(int level, size_t address, bool dirty) {
+    handleVictim(level, levelCache(level)->insert(address, dirty));
+}
+
+// Helper: Copy a block hit at a lower level into the levels above it;
+// exclusive hierarchies move it to L1 instead
+void CacheHierarchy::promote(int level, size_t address, bool dirty) {
+    if (inclusion == InclusionPolicy::EXCLUSIVE) {
+        bool was_dirty = false;
+        levelCache(level)->invalidate(address, was_dirty);
+        fillLevel(0, address, dirty || was_dirty);
+        return;
+    }
+    
+    for (int upper = level - 1; upper >= 0; upper--) {
+        if (levelCache(upper) != nullptr) fillLevel(upper, address, dirty);
+    }
+}
+
+// Helper: Route a line displaced from a level. Dirty data is written to
+// the next level down (or memory); the inclusion policy decides the rest.
+void CacheHierarchy::handleVictim(int level, const CacheVictim& victim) {
+    if (!victim.valid) return;
+    
+    // L1 victims park in the victim cache; the line it displaces moves on
+    CacheVictim line = victim;
+    if (level == 0 && victim_cache != nullptr) {
+        line = victim_cache->insert(victim.address, victim.dirty);
+        if (!line.valid) return;
+    }
+    
+    if (inclusion == InclusionPolicy::EXCLUSIVE) {
+        // Victim-swap: the line moves one level down, dirty state and all
+        int lower = nextLevel(level);
+        victims_moved++;
+        if (lower < 3) {
+            fillLevel(lower, line.address, line.dirty);
+        } else if (line.dirty) {
+            writeBackBelow(level, line.address);
+        }
+        return;
+    }
+    
+    bool dirty = line.dirty;
+    if (inclusion == InclusionPolicy::INCLUSIVE && level > 0) {
+        // Upper copies of the block go too; newer dirty data in them
+        // leaves with the victim
+        for (int upper = 0; upper < level; upper++) {
+            if (levelCache(upper) != nullptr) {
+                dirty |= backInvalidate(levelCache(upper), line.address);
+            }
+        }
+        if (victim_cache != nullptr) dirty |= backInvalidate(victim_cache, line.address);
+    }
+    if (dirty) writeBackBelow(level, line.address);
+}
+
+// Helper: Invalidate an upper level's copy of a block; true if it was dirty
+bool CacheHierarchy::backInvalidate(Cache* cache, size_t address) {
+    bool was_dirty = false;
+    if (!cache->evict(address, was_dirty)) return false;
+    
+    back_invalidations++;
+    if (was_dirty) dirty_back_invalidations++;
+    return was_dirty;
+}
+
+// Helper: Send dirty data leaving a level to the next level down, or memory
+void CacheHierarchy::writeBackBelow(int level, size_t address) {
+    int lower = nextLevel(level);
+    if (lower < 3) {
+        fillLevel(lower, address, true);
+    } else {
+        memory_writes++;
+        memory_writebacks++;
+    }
+}
+
+// Helper: Next existing level below a level (3 = memory)
+int CacheHierarchy::nextLevel(int level) const {
+    int lower = level + 1;
+    while (lower < 3 && levelCache(lower) == nullptr) lower++;
+    return lower;
+}
+
+// Helper: Add one level's cycles to an access (level 3 = memory)
+void CacheHierarchy::chargeCycles(int level, int cycles, int& penalty) {
+    penalty += cycles;
+    level_cycles[level] += cycles;
+}
+
+// Helper: Average access time seen by requests arriving at a level
+// (level 3 = memory): hit rate * hit latency + miss rate * (miss
+// latency + AMAT of the next level), from the level's own hit ratio
+double CacheHierarchy::levelAmat(int level) const {
+    if (level == 3) return latency.memory;
+    
+    const Cache* cache = levelCache(level);
+    int next = nextLevel(level);
+    
+    double miss_rate = (cache->getTotalAccesses() > 0)
+                       ? (double)cache->getMisses() / cache->getTotalAccesses() : 0.0;
+    return (1.0 - miss_rate) * latency.hit[level] +
+           miss_rate * (latency.miss[level] + levelAmat(next));
 }
 
 // Read operation through hierarchy
-bool CacheHierarchy::read(size_t address, bool verbose) {
+bool CacheHierarchy::read(size_t address) {
     total_accesses++;
     total_reads++;
     int penalty = 0;
     
-    if (verbose) cout << "\nReading address " << address << ":\n";
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_ACCESS, address));
     
-    // Step 1: Try L1
-    if (l1->read(address)) {
+    // Step 1: Try L1, then the victim cache and outstanding misses
+    bool victim_dirty = false;
+    bool victim_hit = takeFromVictimCache(address, victim_dirty);
+    if (lookup(0, address, false, penalty)) {
         l1_hits++;
-        penalty = 1;
-        if (verbose) cout << "  [OK] L1 HIT (1 cycle)\n";
+        chargeCycles(0, latency.hit[0], penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_HIT, latency.hit[0], penalty, 0, 0, 1));
         total_penalty_cycles += penalty;
+        read_cycles += penalty;
         return false;  // No memory access needed
     }
     
     // L1 miss
-    penalty += l1_penalty;
-    if (verbose) cout << "  [X] L1 MISS (+" << l1_penalty << " cycles)";
+    chargeCycles(0, latency.miss[0], penalty);
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_MISS, latency.miss[0], has_l2 ? 2 : (has_l3 ? 3 : 0), 0, 0, 1));
+    if (serveL1Miss(address, false, victim_hit, victim_dirty, penalty)) {
+        total_penalty_cycles += penalty;
+        read_cycles += penalty;
+        return false;
+    }
     
     // Step 2: Try L2 (if exists)
     if (has_l2) {
-        if (verbose) cout << " -> checking L2...\n";
-        
-        if (l2->read(address)) {
+        if (lookup(1, address, false, penalty)) {
             l2_hits++;
-            penalty += 10;
-            if (verbose) cout << "  [OK] L2 HIT (10 cycles, total: " << penalty << " cycles)\n";
-            l1->insert(address);
-            if (verbose) cout << "  -> Updated L1\n";
+            chargeCycles(1, latency.hit[1], penalty);
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_HIT, latency.hit[1], penalty, 0, 0, 2));
+            promote(1, address, false);
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_PROMOTE, 0, 0, 0, 0, 1));
             total_penalty_cycles += penalty;
+            read_cycles += penalty;
             return false;
         }
         
         // L2 miss
-        penalty += l2_penalty;
-        if (verbose) cout << "  [X] L2 MISS (+" << l2_penalty << " cycles)";
+        chargeCycles(1, latency.miss[1], penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_MISS, latency.miss[1], has_l3 ? 3 : 0, 0, 0, 2));
     }
     
     // Step 3: Try L3 (if exists)
     if (has_l3) {
-        if (verbose) cout << " -> checking L3...\n";
-        
-        if (l3->read(address)) {
+        if (lookup(2, address, false, penalty)) {
             l3_hits++;
-            penalty += 50;
-            if (verbose) cout << "  [OK] L3 HIT (50 cycles, total: " << penalty << " cycles)\n";
-            if (has_l2) l2->insert(address);
-            l1->insert(address);
-            if (verbose) cout << "  -> Updated caches\n";
+            chargeCycles(2, latency.hit[2], penalty);
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_HIT, latency.hit[2], penalty, 0, 0, 3));
+            promote(2, address, false);
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_PROMOTE));
             total_penalty_cycles += penalty;
+            read_cycles += penalty;
             return false;
         }
         
-        penalty += l3_penalty;
-        if (verbose) cout << "  [X] L3 MISS (+" << l3_penalty << " cycles)";
+        chargeCycles(2, latency.miss[2], penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_MISS, latency.miss[2], 0, 0, 0, 3));
     }
     
-    if (verbose) cout << " -> accessing MEMORY\n";
-    
     // Step 4: Memory access
     memory_accesses++;
-    penalty += memory_penalty;
-    if (verbose) cout << "  -> MEMORY ACCESS (+" << memory_penalty << " cycles, total: " << penalty << " cycles)\n";
+    chargeCycles(3, latency.memory, penalty);
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_MEMORY, latency.memory, penalty));
     
-    // Update all caches
-    if (has_l3) {
-        l3->insert(address);
-        if (verbose) cout << "  -> Updated L3\n";
+    // Update all caches (exclusive: L1 only)
+    if (has_l3 && inclusion != InclusionPolicy::EXCLUSIVE) {
+        fillLevel(2, address, false);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_FILL, 0, 0, 0, 0, 3));
     }
-    if (has_l2) {
-        l2->insert(address);
-        if (verbose) cout << "  -> Updated L2\n";
+    if (has_l2 && inclusion != InclusionPolicy::EXCLUSIVE) {
+        fillLevel(1, address, false);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_FILL, 0, 0, 0, 0, 2));
     }
-    l1->insert(address);
-    if (verbose) cout << "  -> Updated L1\n";
+    fillLevel(0, address, false);
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_FILL, 0, 0, 0, 0, 1));
     
     total_penalty_cycles += penalty;
+    read_cycles += penalty;
     return true;  // Memory accessed
 }
 
 // Write operation through hierarchy
-bool CacheHierarchy::write(size_t address, bool verbose) {
+bool CacheHierarchy::write(size_t address) {
     total_accesses++;
     total_writes++;
     int penalty = 0;
     
-    if (verbose) cout << "\nWriting to address " << address << ":\n";
+    // Write-through vs write-back is decided by L1's policy
+    bool is_write_through = (l1->getWritePolicy() == WritePolicy::WRITE_THROUGH);
+    uint8_t flags = EVENT_WRITE | (is_write_through ? EVENT_WRITE_THROUGH : 0);
+    
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_ACCESS, address, 0, 0, 0, 0, flags));
     
-    // Step 1: Try L1
-    if (l1->write(address)) {
+    // Step 1: Try L1, then the victim cache and outstanding misses
+    bool victim_dirty = false;
+    bool victim_hit = takeFromVictimCache(address, victim_dirty);
+    if (lookup(0, address, true, penalty)) {
         l1_hits++;
-        penalty = 1;
+        chargeCycles(0, latency.hit[0], penalty);
         
         // For write-through, every write goes to memory immediately
-        if (l1->getWritePolicy() == WritePolicy::WRITE_THROUGH) {
-            memory_writes++;
-            if (verbose) cout << "  [OK] L1 WRITE HIT (1 cycle) -> Write-through to memory\n";
-        } else {
-            // Write-back: write stays in cache (dirty bit set)
-            if (verbose) cout << "  [OK] L1 WRITE HIT (1 cycle) -> Cached (dirty)\n";
-        }
+        // Write-back: write stays in cache (dirty bit set)
+        if (is_write_through) memory_writes++;
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_HIT, latency.hit[0], penalty, 0, 0, 1, flags));
         
         total_penalty_cycles += penalty;
+        write_cycles += penalty;
         return false;  // No memory read needed for cache hit
     }
     
     // L1 miss
-    penalty += l1_penalty;
-    if (verbose) cout << "  [X] L1 WRITE MISS (+" << l1_penalty << " cycles)";
+    chargeCycles(0, latency.miss[0], penalty);
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_MISS, latency.miss[0], has_l2 ? 2 : (has_l3 ? 3 : 0), 0, 0, 1, flags));
+    if (serveL1Miss(address, true, victim_hit, victim_dirty, penalty)) {
+        total_penalty_cycles += penalty;
+        write_cycles += penalty;
+        return false;
+    }
     
     // Step 2: Try L2 (if exists)
     if (has_l2) {
-        if (verbose) cout << " -> checking L2...\n";
-        
-        if (l2->write(address)) {
+        if (lookup(1, address, true, penalty)) {
             l2_hits++;
-            penalty += 10;
+            chargeCycles(1, latency.hit[1], penalty);
             
             // For write-through, propagate to memory
-            if (l1->getWritePolicy() == WritePolicy::WRITE_THROUGH) {
-                memory_writes++;
-                if (verbose) cout << "  [OK] L2 WRITE HIT (10 cycles) -> Write-through to memory\n";
-            } else {
-                if (verbose) cout << "  [OK] L2 WRITE HIT (10 cycles) -> Cached (dirty)\n";
-            }
+            if (is_write_through) memory_writes++;
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_HIT, latency.hit[1], penalty, 0, 0, 2, flags));
             
-            l1->insert(address, l1->getWritePolicy() == WritePolicy::WRITE_BACK);
-            if (verbose) cout << "  -> Updated L1\n";
+            promote(1, address, !is_write_through);
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_PROMOTE, 0, 0, 0, 0, 1, flags));
             total_penalty_cycles += penalty;
+            write_cycles += penalty;
             return false;
         }
         
         // L2 miss
-        penalty += l2_penalty;
-        if (verbose) cout << "  [X] L2 WRITE MISS (+" << l2_penalty << " cycles)";
+        chargeCycles(1, latency.miss[1], penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_MISS, latency.miss[1], has_l3 ? 3 : 0, 0, 0, 2, flags));
     }
     
     // Step 3: Try L3 (if exists)
     if (has_l3) {
-        if (verbose) cout << " -> checking L3...\n";
-        
-        if (l3->write(address)) {
+        if (lookup(2, address, true, penalty)) {
             l3_hits++;
-            penalty += 50;
+            chargeCycles(2, latency.hit[2], penalty);
             
             // For write-through, propagate to memory
-            bool is_write_through = (l1->getWritePolicy() == WritePolicy::WRITE_THROUGH);
-            if (is_write_through) {
-                memory_writes++;
-                if (verbose) cout << "  [OK] L3 WRITE HIT (50 cycles) -> Write-through to memory\n";
-            } else {
-                if (verbose) cout << "  [OK] L3 WRITE HIT (50 cycles) -> Cached (dirty)\n";
-            }
+            if (is_write_through) memory_writes++;
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_HIT, latency.hit[2], penalty, 0, 0, 3, flags));
             
-            bool mark_dirty = !is_write_through;
-            if (has_l2) l2->insert(address, mark_dirty);
-            l1->insert(address, mark_dirty);
-            if (verbose) cout << "  -> Updated caches\n";
+            promote(2, address, !is_write_through);
+            if (sink) sink->emit(SimEvent(SimEventType::CACHE_PROMOTE, 0, 0, 0, 0, 0, flags));
             total_penalty_cycles += penalty;
+            write_cycles += penalty;
             return false;
         }
         
-        penalty += l3_penalty;
-        if (verbose) cout << "  [X] L3 WRITE MISS (+" << l3_penalty << " cycles)";
+        chargeCycles(2, latency.miss[2], penalty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_MISS, latency.miss[2], 0, 0, 0, 3, flags));
     }
     
-    if (verbose) cout << " -> accessing MEMORY\n";
-    
     // Step 4: Memory access (write-allocate policy)
     // On write miss, we need to fetch the block from memory first
     memory_accesses++;  // This is a memory READ to fetch the block
-    penalty += memory_penalty;
+    chargeCycles(3, latency.memory, penalty);
     
-    // Determine if we also need to write to memory based on L1's write policy
-    bool is_write_through = (l1->getWritePolicy() == WritePolicy::WRITE_THROUGH);
-    
-    if (is_write_through) {
-        // Write-through: Also write to memory
-        memory_writes++;
-        if (verbose) cout << "  -> MEMORY READ+WRITE (" << memory_penalty << " cycles, total: " << penalty << " cycles)\n";
-        if (verbose) cout << "  -> Write-through: data written to memory\n";
-    } else {
-        // Write-back: Only read block, write stays in cache
-        if (verbose) cout << "  -> MEMORY READ (fetch block) (" << memory_penalty << " cycles, total: " << penalty << " cycles)\n";
-        if (verbose) cout << "  -> Write-back: data cached as dirty\n";
-    }
+    // Write-through also writes to memory; write-back only reads the block
+    if (is_write_through) memory_writes++;
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_MEMORY, latency.memory, penalty, 0, 0, 0, flags));
     
     // Update all caches with dirty flag (for write-back) or clean (for write-through)
     bool mark_dirty = !is_write_through;  // Only dirty for write-back
+    uint8_t fill_flags = flags | (mark_dirty ? EVENT_DIRTY : 0);
     
-    if (has_l3) {
-        l3->insert(address, mark_dirty);
-        if (verbose) cout << "  -> Updated L3" << (mark_dirty ? " (dirty)" : " (clean)") << "\n";
+    if (has_l3 && inclusion != InclusionPolicy::EXCLUSIVE) {
+        fillLevel(2, address, mark_dirty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_FILL, 0, 0, 0, 0, 3, fill_flags));
     }
-    if (has_l2) {
-        l2->insert(address, mark_dirty);
-        if (verbose) cout << "  -> Updated L2" << (mark_dirty ? " (dirty)" : " (clean)") << "\n";
+    if (has_l2 && inclusion != InclusionPolicy::EXCLUSIVE) {
+        fillLevel(1, address, mark_dirty);
+        if (sink) sink->emit(SimEvent(SimEventType::CACHE_FILL, 0, 0, 0, 0, 2, fill_flags));
     }
-    l1->insert(address, mark_dirty);
-    if (verbose) cout << "  -> Updated L1" << (mark_dirty ? " (dirty)" : " (clean)") << "\n";
+    fillLevel(0, address, mark_dirty);
+    if (sink) sink->emit(SimEvent(SimEventType::CACHE_FILL, 0, 0, 0, 0, 1, fill_flags));
     
     total_penalty_cycles += penalty;
+    write_cycles += penalty;
     return true;  // Memory accessed
 }
 
 // Generic access (defaults to read)
-bool CacheHierarchy::access(size_t address, bool verbose) {
-    return read(address, verbose);
+bool CacheHierarchy::access(size_t address) {
+    return read(address);
 }
     
 // Display all statistics
@@ -638,10 +1420,13 @@ void CacheHierarchy::displayStats() const {
     }
     cout << "  Memory accesses: " << memory_accesses << "\n";
     cout << "  Memory writes: " << memory_writes << "\n";
+    if (memory_writebacks > 0) {
+        cout << "    (dirty write-backs: " << memory_writebacks << ")\n";
+    }
     
     double overall_hit_ratio = 0.0;
     if (total_accesses > 0) {
-        int total_hits = l1_hits + l2_hits;
+        uint64_t total_hits = l1_hits + l2_hits + victim_hits;
         if (has_l3) total_hits += l3_hits;
         overall_hit_ratio = ((double)total_hits / total_accesses) * 100.0;
     }
@@ -649,7 +1434,7 @@ void CacheHierarchy::displayStats() const {
               << overall_hit_ratio << "%\n";
     
     // Total write-backs
-    int total_writebacks = l1->getWritebacks();
+    uint64_t total_writebacks = l1->getWritebacks();
     if (has_l2) total_writebacks += l2->getWritebacks();
     if (has_l3) total_writebacks += l3->getWritebacks();
     
@@ -657,13 +1442,87 @@ void CacheHierarchy::displayStats() const {
         cout << "  Total write-backs: " << total_writebacks << "\n";
     }
     
+    // Effective capacity: distinct blocks held across all levels
+    vector<size_t> resident;
+    int total_lines = 0;
+    for (int level = 0; level < 3; level++) {
+        Cache* cache = levelCache(level);
+        if (cache == nullptr) continue;
+        cache->residentBlocks(resident);
+        total_lines += cache->getCapacity();
+    }
+    if (victim_cache != nullptr) {
+        victim_cache->residentBlocks(resident);
+        total_lines += victim_cache->getCapacity();
+    }
+    sort(resident.begin(), resident.end());
+    size_t unique_blocks = unique(resident.begin(), resident.end()) - resident.begin();
+    
+    cout << "  Inclusion policy: " << inclusionPolicyName(inclusion) << "\n";
+    cout << "  Unique blocks cached: " << unique_blocks << " (of " << total_lines << " lines)\n";
+    if (inclusion == InclusionPolicy::INCLUSIVE) {
+        cout << "  Back-invalidations: " << back_invalidations
+             << " (dirty: " << dirty_back_invalidations << ")\n";
+    } else if (inclusion == InclusionPolicy::EXCLUSIVE) {
+        cout << "  Victims moved down: " << victims_moved << "\n";
+    }
+    if (victim_cache != nullptr) {
+        double victim_ratio = (victim_probes > 0) ? (double)victim_hits / victim_probes * 100.0 : 0.0;
+        cout << "  Victim cache: " << victim_cache->getCapacity() << " entries, "
+             << victim_latency << (victim_latency == 1 ? " cycle" : " cycles") << "\n";
+        cout << "  Victim cache hits: " << victim_hits << " of " << victim_probes
+             << " L1 misses (" << fixed << setprecision(2) << victim_ratio << "%)\n";
+    }
+    if (mshr_entries > 0) {
+        cout << "  MSHRs: " << mshr_entries << " (window " << mshr_window << " cycles)\n";
+        cout << "  MSHR merges: " << mshr_merges << "\n";
+        cout << "  MSHR-full stalls: " << mshr_full_stalls
+             << " (" << mshr_stall_cycles << " cycles)\n";
+    }
+    
     cout << "\nMiss Penalty Analysis:\n";
     cout << "  Total penalty cycles: " << total_penalty_cycles << "\n";
     if (total_accesses > 0) {
         double avg_penalty = (double)total_penalty_cycles / total_accesses;
         cout << "  Average cycles per access: " << fixed << setprecision(2) << avg_penalty << "\n";
     }
-    cout << "  (L1 hit=1, L2 hit=10, L3 hit=50, Memory=100 cycles)\n";
+    cout << "  (L1 hit=" << latency.hit[0] << ", L2 hit=" << latency.hit[1]
+         << ", L3 hit=" << latency.hit[2] << ", Memory=" << latency.memory << " cycles)\n";
+    if (total_reads > 0) {
+        cout << "  Read cycles: " << read_cycles << " (avg " << fixed << setprecision(2)
+             << (double)read_cycles / total_reads << " per read)\n";
+    }
+    if (total_writes > 0) {
+        cout << "  Write cycles: " << write_cycles << " (avg " << fixed << setprecision(2)
+             << (double)write_cycles / total_writes << " per write)\n";
+    }
+    
+    cout << "\nAMAT by Level (cycles):\n";
+    const char* level_names[4] = { "L1", "L2", "L3", "Memory" };
+    for (int level = 0; level < 4; level++) {
+        if ((level == 1 && !has_l2) || (level == 2 && !has_l3)) continue;
+        double share = (total_penalty_cycles > 0)
+                       ? (double)level_cycles[level] / total_penalty_cycles * 100.0 : 0.0;
+        cout << "  " << level_names[level] << ": ";
+        if (level < 3) {
+            cout << "hit=" << latency.hit[level] << ", miss=" << latency.miss[level] << ", ";
+        }
+        cout << "AMAT=" << fixed << setprecision(2) << levelAmat(level)
+             << ", cycles=" << level_cycles[level]
+             << " (" << fixed << setprecision(2) << share << "%)\n";
+    }
+    
+    
+    bool any_prefetcher = false;
+    for (int level = 0; level < 3; level++) {
+        if (prefetchers[level] == nullptr) continue;
+        if (!any_prefetcher) cout << "\nPrefetching:\n";
+        any_prefetcher = true;
+        cout << "  " << level_names[level] << ": " << prefetchers[level]->describe() << "\n";
+    }
+    if (any_prefetcher) {
+        cout << "  Prefetch memory reads: " << prefetch_memory_reads << " (extra memory traffic)\n";
+    }
     
     cout << "========================================\n";
 }
@@ -681,7 +1540,25 @@ void CacheHierarchy::clearAll() {
     l3_hits = 0;
     memory_accesses = 0;
     memory_writes = 0;
+    memory_writebacks = 0;
+    back_invalidations = 0;
+    dirty_back_invalidations = 0;
+    victims_moved = 0;
     total_penalty_cycles = 0;
+    read_cycles = 0;
+    write_cycles = 0;
+    fill(level_cycles, level_cycles + 4, 0);
+    prefetch_memory_reads = 0;
+    if (victim_cache != nullptr) victim_cache->clear();
+    victim_probes = 0;
+    victim_hits = 0;
+    mshrs.clear();
+    mshr_merges = 0;
+    mshr_full_stalls = 0;
+    mshr_stall_cycles = 0;
+    for (Prefetcher* prefetcher : prefetchers) {
+        if (prefetcher != nullptr) prefetcher->reset();
+    }
     cout << "All caches cleared\n";
 }
     
@@ -696,18 +1573,90 @@ void CacheHierarchy::displayContents() const {
         cout << "\n";
         l3->displayContents();
     }
+    if (victim_cache != nullptr) {
+        cout << "\n";
+        victim_cache->displayContents();
+    }
 }
 
 // ==================== HELPER FUNCTIONS ====================
 
-AssociativityType parseAssociativity(string assoc_str) {
-    if (assoc_str == "direct") return AssociativityType::DIRECT_MAPPED;
-    if (assoc_str == "2way") return AssociativityType::TWO_WAY;
-    if (assoc_str == "4way") return AssociativityType::FOUR_WAY;
+// Accepts "direct", "fully" and "<n>way" for any n >= 1; ways receives
+// the way count (0 for fully associative, which uses every line)
+AssociativityType parseAssociativity(string assoc_str, int& ways) {
+    ways = 0;
+    if (assoc_str == "direct") {
+        ways = 1;
+        return AssociativityType::DIRECT_MAPPED;
+    }
     if (assoc_str == "fully") return AssociativityType::FULLY_ASSOCIATIVE;
+    
+    size_t suffix = assoc_str.size() >= 3 ? assoc_str.size() - 3 : 0;
+    if (suffix > 0 && assoc_str.compare(suffix, 3, "way") == 0 &&
+        assoc_str.find_first_not_of("0123456789") == suffix) {
+        int n = atoi(assoc_str.substr(0, suffix).c_str());
+        if (n >= 1) {
+            ways = n;
+            if (n == 1) return AssociativityType::DIRECT_MAPPED;
+            if (n == 2) return AssociativityType::TWO_WAY;
+            if (n == 4) return AssociativityType::FOUR_WAY;
+            return AssociativityType::N_WAY;
+        }
+    }
     return AssociativityType::FULLY_ASSOCIATIVE;
 }
 
+// Accepts fifo, lru, plru (tree), bitplru, srrip, brrip and random[:seed];
+// anything else is LRU. seed receives the random seed (default 1).
+ReplacementPolicy parseReplacementPolicy(string policy_str, uint64_t& seed) {
+    seed = 1;
+    if (policy_str == "fifo") return ReplacementPolicy::FIFO;
+    if (policy_str == "plru" || policy_str == "tree-plru" || policy_str == "treeplru") {
+        return ReplacementPolicy::TREE_PLRU;
+    }
+    if (policy_str == "bitplru" || policy_str == "bit-plru" || policy_str == "mru") {
+        return ReplacementPolicy::BIT_PLRU;
+    }
+    if (policy_str == "srrip") return ReplacementPolicy::SRRIP;
+    if (policy_str == "brrip") return ReplacementPolicy::BRRIP;
+    if (policy_str.compare(0, 6, "random") == 0) {
+        if (policy_str.size() > 7 && policy_str[6] == ':') {
+            seed = strtoull(policy_str.c_str() + 7, nullptr, 10);
+        }
+        return ReplacementPolicy::RANDOM;
+    }
+    return ReplacementPolicy::LRU;
+}
+
+string replacementPolicyName(ReplacementPolicy policy) {
+    switch (policy) {
+        case ReplacementPolicy::FIFO: return "FIFO";
+        case ReplacementPolicy::LRU: return "LRU";
+        case ReplacementPolicy::TREE_PLRU: return "Tree-PLRU";
+        case ReplacementPolicy::BIT_PLRU: return "Bit-PLRU";
+        case ReplacementPolicy::SRRIP: return "SRRIP";
+        case ReplacementPolicy::BRRIP: return "BRRIP";
+        case ReplacementPolicy::RANDOM: return "Random";
+    }
+    return "LRU";
+}
+
+bool parseInclusionPolicy(const string& policy_str, InclusionPolicy& policy) {
+    if (policy_str == "nine") policy = InclusionPolicy::NINE;
+    else if (policy_str == "inclusive") policy = InclusionPolicy::INCLUSIVE;
+    else if (policy_str == "exclusive") policy = InclusionPolicy::EXCLUSIVE;
+    else return false;
+    return true;
+}
+
+string inclusionPolicyName(InclusionPolicy policy) {
+    switch (policy) {
+        case InclusionPolicy::INCLUSIVE: return "Inclusive";
+        case InclusionPolicy::EXCLUSIVE: return "Exclusive";
+        default: return "NINE";
+    }
+}
+
 WritePolicy parseWritePolicy(string write_str) {
     if (write_str == "wt" || write_str == "write-through" || write_str == "writethrough") {
         return WritePolicy::WRITE_THROUGH;
@@ -0,0 +1,158 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "prefetcher.h"
+
+using namespace std;
+
+// Stride table entries (direct-mapped by region number)
+static const int STRIDE_TABLE_SIZE = 64;
+static const uint64_t STRIDE_REGION_BYTES = 4096;
+
+// Concurrent streams tracked by the stream prefetcher
+static const int STREAM_BUFFERS = 8;
+
+// ==================== PREFETCHER CLASS IMPLEMENTATION ====================
+
+// Constructor
+Prefetcher::Prefetcher(const PrefetchConfig& config, int blk_size)
+    : type(config.type), degree(max(1, config.degree)), distance(max(1, config.distance)),
+      block_size(blk_size), stream_clock(0) {
+    reset();
+}
+
+// Forget all training state
+void Prefetcher::reset() {
+    // Value-initialized entries are all invalid
+    stride_table.assign(type == PrefetchType::STRIDE ? STRIDE_TABLE_SIZE : 0, StrideEntry());
+    streams.assign(type == PrefetchType::STREAM ? STREAM_BUFFERS : 0, StreamBuffer());
+    stream_clock = 0;
+}
+
+// Helper: Learn the stride of the block's region; prefetch once it repeats
+void Prefetcher::trainStride(uint64_t block, vector<uint64_t>& candidates) {
+    uint64_t region = block * (uint64_t)block_size / STRIDE_REGION_BYTES;
+    StrideEntry& entry = stride_table[region % STRIDE_TABLE_SIZE];
+    
+    if (!entry.valid || entry.region != region) {
+        entry.valid = true;
+        entry.region = region;
+        entry.last_block = block;
+        entry.stride = 0;
+        entry.confidence = 0;
+        return;
+    }
+    
+    int64_t delta = (int64_t)(block - entry.last_block);
+    if (delta == 0) return;
+    
+    if (delta == entry.stride) {
+        entry.confidence = min(entry.confidence + 1, 3);
+    } else {
+        entry.stride = delta;
+        entry.confidence = 0;
+    }
+    entry.last_block = block;
+    
+    if (entry.confidence == 0) return;
+    
+    for (int i = 0; i < degree; i++) {
+        int64_t target = (int64_t)block + entry.stride * (distance + i);
+        if (target < 0) break;
+        candidates.push_back((uint64_t)target);
+    }
+}
+
+// Helper: Advance the stream the block belongs to, or start a new one
+void Prefetcher::trainStream(uint64_t block, vector<uint64_t>& candidates) {
+    stream_clock++;
+    int64_t window = distance + degree;
+    
+    for (StreamBuffer& stream : streams) {
+        if (!stream.valid) continue;
+        int64_t delta = (int64_t)(block - stream.last_block);
+        if (delta == 0 || delta > window || delta < -window) continue;
+        
+        int direction = (delta > 0) ? 1 : -1;
+        if (stream.direction == 0) {
+            // Second trigger confirms the direction
+            stream.direction = direction;
+            stream.next_block = block + direction * distance;
+        } else if (direction != stream.direction) {
+            continue;
+        }
+        stream.last_block = block;
+        stream.last_use = stream_clock;
+        
+        // Keep the stream `degree` blocks deep, `distance` blocks ahead
+        int64_t last_target = (int64_t)block + stream.direction * (distance + degree - 1);
+        int64_t next = (int64_t)stream.next_block;
+        if ((next - (int64_t)block) * stream.direction < distance) {
+            next = (int64_t)block + stream.direction * distance;
+        }
+        while ((last_target - next) * stream.direction >= 0 && next >= 0) {
+            candidates.push_back((uint64_t)next);
+            next += stream.direction;
+        }
+        stream.next_block = (uint64_t)max<int64_t>(next, 0);
+        return;
+    }
+    
+    // No stream matched: replace a free or the least recently used buffer
+    StreamBuffer* victim = &streams[0];
+    for (StreamBuffer& stream : streams) {
+        if (!stream.valid) {
+            victim = &stream;
+            break;
+        }
+        if (stream.last_use < victim->last_use) victim = &stream;
+    }
+    victim->valid = true;
+    victim->last_block = block;
+    victim->direction = 0;
+    victim->next_block = block;
+    victim->last_use = stream_clock;
+}
+
+// Appends the block numbers to prefetch after a trigger at block
+void Prefetcher::train(uint64_t block, vector<uint64_t>& candidates) {
+    switch (type) {
+        case PrefetchType::NEXT_LINE:
+            for (int i = 0; i < degree; i++) {
+                candidates.push_back(block + distance + i);
+            }
+            break;
+        case PrefetchType::STRIDE:
+            trainStride(block, candidates);
+            break;
+        case PrefetchType::STREAM:
+            trainStream(block, candidates);
+            break;
+    }
+}
+
+// Short description for statistics
+string Prefetcher::describe() const {
+    string name = (type == PrefetchType::NEXT_LINE) ? "next-line" :
+                  (type == PrefetchType::STRIDE) ? "stride" : "stream";
+    return name + " (degree " + to_string(degree) + ", distance " + to_string(distance) + ")";
+}
+
+// ==================== HELPER FUNCTIONS ====================
+
+bool parsePrefetchType(const string& type_str, PrefetchType& type) {
+    if (type_str == "nextline" || type_str == "next-line" || type_str == "next_line") {
+        type = PrefetchType::NEXT_LINE;
+        return true;
+    }
+    if (type_str == "stride") {
+        type = PrefetchType::STRIDE;
+        return true;
+    }
+    if (type_str == "stream") {
+        type = PrefetchType::STREAM;
+        return true;
+    }
+    return false;
+}
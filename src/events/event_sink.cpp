@@ -0,0 +1,452 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+#include "event_sink.h"
+#include "virtual_memory_simulator.h"
+
+using namespace std;
+
+// ==================== TEXT SINK ====================
+
+void TextEventSink::emit(const SimEvent& event) {
+    if (event.type <= SimEventType::NO_ALLOCATOR) {
+        emitSystem(event);
+    } else if (event.type <= SimEventType::BUDDY_MERGED) {
+        emitAllocator(event);
+    } else if (event.type <= SimEventType::VM_PAGE_LOADED) {
+        emitVirtualMemory(event);
+    } else if (verbose) {
+        emitCache(event);
+    }
+}
+
+// Unified access banner, steps and summary
+void TextEventSink::emitSystem(const SimEvent& event) {
+    bool is_write = (event.flags & EVENT_WRITE) != 0;
+    
+    switch (event.type) {
+        case SimEventType::ACCESS_BEGIN:
+            out << "\n+==========================================================+\n";
+            out << "|                  UNIFIED MEMORY ACCESS                   |\n";
+            out << "+==========================================================+\n";
+            if (event.flags & EVENT_VM) {
+                out << "\n  [STEP 1] VIRTUAL MEMORY - Address Translation\n";
+                out << "  ---------------------------------------------------\n";
+                out << "  Input: Virtual Address 0x" << hex << event.a << dec << " (" << event.a << ")\n";
+            } else {
+                out << "\n  [STEP 1] VIRTUAL MEMORY: Disabled\n";
+                out << "  Using direct physical addressing\n";
+                out << "  Physical Address: 0x" << hex << event.a << dec << " (" << event.a << ")\n";
+            }
+            break;
+        
+        case SimEventType::ACCESS_TRANSLATED:
+            out << "  [OK] Translation successful\n";
+            out << "  Output: Physical Address 0x" << hex << event.b << dec << " (" << event.b << ")\n";
+            break;
+        
+        case SimEventType::ACCESS_TRANSLATION_FAILED:
+            out << "\n  [X] Address translation FAILED\n";
+            out << "  Access terminated.\n";
+            break;
+        
+        case SimEventType::ACCESS_CACHE_BEGIN:
+            if (event.flags & EVENT_CACHE) {
+                out << "\n  [STEP 2] CACHE HIERARCHY - Multi-level Cache Check\n";
+                out << "  ---------------------------------------------------\n";
+                out << "  Operation: " << (is_write ? "WRITE" : "READ") << "\n";
+                out << "  Checking L1";
+                if (event.level & 0x2) out << " -> L2";
+                if (event.level & 0x4) out << " -> L3";
+                out << " -> Memory...\n\n";
+            } else {
+                out << "\n  [STEP 2] CACHE HIERARCHY: Disabled\n";
+                out << "  Direct memory access\n";
+            }
+            break;
+        
+        case SimEventType::ACCESS_END:
+            if (event.flags & EVENT_MEMORY) {
+                out << "\n  [STEP 3] PHYSICAL MEMORY - Final Access\n";
+                out << "  ---------------------------------------------------\n";
+                out << "  " << (is_write ? "Writing to" : "Reading from") << " physical memory at 0x" << hex << event.b << dec << "\n";
+                out << "  Memory allocator: " << ((event.flags & EVENT_BUDDY) ? "Buddy System" : "Classic") << "\n";
+            }
+            
+            out << "\n  [OK] Memory access complete\n";
+            
+            out << "\n  +====================================================+\n";
+            out << "  |                      SUMMARY                       |\n";
+            out << "  +====================================================+\n";
+            
+            if (event.flags & EVENT_VM) {
+                out << "  Virtual Address:   0x" << hex << event.a << dec << " (" << event.a << ")\n";
+            }
+            out << "  Physical Address:  0x" << hex << event.b << dec << " (" << event.b << ")\n";
+            
+            out << "  Operation: " << (is_write ? "WRITE" : "READ") << "\n";
+            out << "  Flow: ";
+            if (event.flags & EVENT_VM) out << "VM Translation -> ";
+            if (event.flags & EVENT_CACHE) out << "Cache Hierarchy -> ";
+            if (event.flags & EVENT_MEMORY) out << "Physical Memory\n";
+            else out << "\n";
+            out << "  Status: SUCCESS\n\n";
+            break;
+        
+        case SimEventType::ALLOC_REQUEST:
+            out << "\n========================================\n";
+            out << "Memory Allocation Request\n";
+            out << "========================================\n";
+            break;
+        
+        case SimEventType::FREE_REQUEST:
+            out << "\n========================================\n";
+            out << "Memory Deallocation Request\n";
+            out << "========================================\n";
+            break;
+        
+        case SimEventType::NO_ALLOCATOR:
+            out << "Error: No memory allocator initialized!\n";
+            break;
+        
+        default:
+            break;
+    }
+}
+
+// Classic and buddy allocator results
+void TextEventSink::emitAllocator(const SimEvent& event) {
+    switch (event.type) {
+        case SimEventType::ALLOC_ZERO_SIZE:
+            out << "Error: Cannot allocate 0 bytes\n";
+            break;
+        
+        case SimEventType::ALLOC_NO_MEMORY:
+            out << "Error: Not enough memory to allocate " << event.a << " bytes\n";
+            break;
+        
+        case SimEventType::ALLOC_SUCCESS:
+            out << "Allocated block id=" << event.a
+                << " at address=0x" << hex << setw(4)
+                << setfill('0') << event.b
+                << dec << " (" << event.c << " bytes)\n";
+            break;
+        
+        case SimEventType::FREE_NOT_FOUND:
+            out << "Error: Block " << (int)event.a << " not found\n";
+            break;
+        
+        case SimEventType::FREE_SUCCESS:
+            out << "Block " << event.a << " freed and merged\n";
+            break;
+        
+        case SimEventType::BUDDY_TOO_LARGE:
+            out << "Error: Requested size exceeds total memory\n";
+            break;
+        
+        case SimEventType::BUDDY_REQUEST:
+            out << "\nAllocation request #" << event.a << ":\n";
+            out << "  Requested: " << event.b << " bytes\n";
+            out << "  Rounded to: " << event.c << " bytes (order " << event.d << ")\n";
+            break;
+        
+        case SimEventType::BUDDY_SPLIT:
+            out << "  No free block at order " << event.a << ", splitting larger blocks...\n";
+            break;
+        
+        case SimEventType::BUDDY_SPLIT_FAILED:
+            out << "  ERROR: Out of memory (cannot split)\n";
+            break;
+        
+        case SimEventType::BUDDY_OUT_OF_MEMORY:
+            out << "  ERROR: Out of memory\n";
+            break;
+        
+        case SimEventType::BUDDY_ALLOC_SUCCESS:
+            out << "  SUCCESS: Allocated block_id=" << event.a;
+            out << " at address 0x" << hex << event.b << dec;
+            out << " (size=" << event.c << " bytes)\n";
+            if (event.d > 0) {
+                out << "  Internal fragmentation: " << event.d << " bytes";
+                double frag_percent = (double)event.d / event.c * 100.0;
+                out << " (" << fixed << setprecision(2) << frag_percent << "%)\n";
+            }
+            break;
+        
+        case SimEventType::BUDDY_FREE_INVALID:
+            out << "\nError: Invalid block_id " << (int)event.a << "\n";
+            break;
+        
+        case SimEventType::BUDDY_FREE:
+            out << "\nDeallocation:\n";
+            out << "  Block ID: " << event.a << "\n";
+            out << "  Address: 0x" << hex << event.b << dec << "\n";
+            out << "  Size: " << event.c << " bytes (order " << event.d << ")\n";
+            out << "  Attempting to merge with buddy...\n";
+            break;
+        
+        case SimEventType::BUDDY_MERGED:
+            if (event.a > 0) {
+                out << "  Performed " << event.a << " merge(s)\n";
+            } else {
+                out << "  No merge possible (buddy not free)\n";
+            }
+            break;
+        
+        default:
+            break;
+    }
+}
+
+// Address translation; verbose selects the step-by-step form
+void TextEventSink::emitVirtualMemory(const SimEvent& event) {
+    switch (event.type) {
+        case SimEventType::VM_ADDRESS_INVALID:
+            out << "ERROR: Virtual address 0x" << hex << event.a << dec
+                << " exceeds virtual memory size!\n";
+            break;
+        
+        case SimEventType::VM_TRANSLATE:
+            if (verbose) {
+                out << "\n--- Address Translation ---\n";
+                out << "Virtual address: 0x" << hex << event.a << dec << " (" << event.a << ")\n";
+                out << "Page number: " << event.b << "\n";
+                out << "Offset: " << event.c << "\n";
+            }
+            break;
+        
+        case SimEventType::VM_PAGE_HIT:
+            if (verbose) {
+                out << "Result: PAGE HIT\n";
+                out << "Frame number: " << event.b << "\n";
+                out << "Physical address: 0x" << hex << event.c << dec << " (" << event.c << ")\n";
+            } else {
+                out << "Virtual 0x" << hex << event.a << " → Physical 0x" << event.c << dec;
+                out << " [HIT]\n";
+            }
+            break;
+        
+        case SimEventType::VM_PAGE_FAULT:
+            if (verbose) {
+                out << "Result: PAGE FAULT\n";
+                out << "Handling page fault for page " << event.b << "...\n";
+            } else {
+                out << "Virtual 0x" << hex << event.a << dec << " [FAULT] ";
+            }
+            break;
+        
+        case SimEventType::VM_FAULT_RESOLVED:
+            if (!verbose) {
+                out << "→ Physical 0x" << hex << event.a << dec << "\n";
+            }
+            break;
+        
+        case SimEventType::VM_FREE_FRAME:
+            if (verbose) out << "Found free frame: " << event.a << "\n";
+            break;
+        
+        case SimEventType::VM_NO_FREE_FRAME:
+            if (verbose) out << "No free frames. Selecting victim page...\n";
+            break;
+        
+        case SimEventType::VM_VICTIM_SELECTED:
+            if (!verbose) break;
+            if ((PageReplacementPolicy)event.c == PageReplacementPolicy::FIFO) {
+                out << "FIFO selected victim: Page " << event.a
+                    << " (load_time=" << event.b << ")\n";
+            } else if ((PageReplacementPolicy)event.c == PageReplacementPolicy::LRU) {
+                out << "LRU selected victim: Page " << event.a
+                    << " (last_access=" << event.b << ")\n";
+            } else if ((PageReplacementPolicy)event.c == PageReplacementPolicy::AGING) {
+                out << "AGING selected victim: Page " << event.a
+                    << " (age=0x" << hex << event.b << dec << ")\n";
+            } else {
+                out << pageReplacementPolicyName((PageReplacementPolicy)event.c)
+                    << " selected victim: Page " << event.a
+                    << " (hand moved " << event.b << ")\n";
+            }
+            break;
+        
+        case SimEventType::VM_VICTIM_MISSING:
+            out << "ERROR: Could not find victim page!\n";
+            break;
+        
+        case SimEventType::VM_EVICT_INVALID:
+            out << "ERROR: Trying to evict invalid page!\n";
+            break;
+        
+        case SimEventType::VM_PAGE_EVICTED:
+            if (!verbose) break;
+            out << "Evicting page " << event.a << " from frame " << event.b;
+            if (event.flags & EVENT_DIRTY) {
+                out << " (dirty - writing to disk)";
+            }
+            out << "\n";
+            break;
+        
+        case SimEventType::VM_PAGE_LOADED:
+            if (verbose) out << "Loading page " << event.a << " into frame " << event.b << "\n";
+            break;
+        
+        default:
+            break;
+    }
+}
+
+// Per-level cache steps (verbose mode only)
+void TextEventSink::emitCache(const SimEvent& event) {
+    bool is_write = (event.flags & EVENT_WRITE) != 0;
+    bool write_through = (event.flags & EVENT_WRITE_THROUGH) != 0;
+    
+    switch (event.type) {
+        case SimEventType::CACHE_ACCESS:
+            out << (is_write ? "\nWriting to address " : "\nReading address ") << event.a << ":\n";
+            break;
+        
+        case SimEventType::CACHE_HIT:
+            out << "  [OK] L" << (int)event.level << (is_write ? " WRITE HIT (" : " HIT (")
+                << event.a << (event.a == 1 ? " cycle" : " cycles");
+            if (is_write) {
+                out << ") -> " << (write_through ? "Write-through to memory" : "Cached (dirty)") << "\n";
+            } else if (event.level > 1) {
+                out << ", total: " << event.b << " cycles)\n";
+            } else {
+                out << ")\n";
+            }
+            break;
+        
+        case SimEventType::CACHE_MISS:
+            out << "  [X] L" << (int)event.level << (is_write ? " WRITE MISS (+" : " MISS (+")
+                << event.a << " cycles)";
+            if (event.b > 0) {
+                out << " -> checking L" << event.b << "...\n";
+            } else {
+                out << " -> accessing MEMORY\n";
+            }
+            break;
+        
+        case SimEventType::CACHE_MEMORY:
+            if (!is_write) {
+                out << "  -> MEMORY ACCESS (+" << event.a << " cycles, total: " << event.b << " cycles)\n";
+            } else if (write_through) {
+                out << "  -> MEMORY READ+WRITE (" << event.a << " cycles, total: " << event.b << " cycles)\n";
+                out << "  -> Write-through: data written to memory\n";
+            } else {
+                out << "  -> MEMORY READ (fetch block) (" << event.a << " cycles, total: " << event.b << " cycles)\n";
+                out << "  -> Write-back: data cached as dirty\n";
+            }
+            break;
+        
+        case SimEventType::CACHE_PROMOTE:
+            if (event.level == 0) {
+                out << "  -> Updated caches\n";
+            } else {
+                out << "  -> Updated L" << (int)event.level << "\n";
+            }
+            break;
+        
+        case SimEventType::CACHE_FILL:
+            out << "  -> Updated L" << (int)event.level;
+            if (is_write) out << ((event.flags & EVENT_DIRTY) ? " (dirty)" : " (clean)");
+            out << "\n";
+            break;
+        
+        case SimEventType::CACHE_VICTIM_HIT:
+            out << "  [OK] VICTIM CACHE HIT (" << event.a << (event.a == 1 ? " cycle" : " cycles")
+                << ", total: " << event.b << " cycles) -> swapped into L1\n";
+            break;
+        
+        case SimEventType::CACHE_MSHR_MERGE:
+            out << "  -> Merged with outstanding miss to block 0x" << hex << event.a << dec << " (MSHR)\n";
+            break;
+        
+        case SimEventType::CACHE_MSHR_STALL:
+            out << "  -> MSHRs full: stalled " << event.a << " cycles\n";
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ==================== BINARY SINK ====================
+
+static const char EVENT_MAGIC[4] = { 'M', 'S', 'E', 'V' };
+static const uint16_t EVENT_VERSION = 1;
+static const size_t EVENT_HEADER_SIZE = 16;
+static const size_t EVENT_RECORD_SIZE = 36;
+
+// Helper: Write a little-endian integer into a byte array
+static void storeLE(uint8_t* dst, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+BinaryEventSink::BinaryEventSink() : event_count(0) {
+    buffer.reserve(1 << 16);
+}
+
+BinaryEventSink::~BinaryEventSink() {
+    if (out.is_open()) close();
+}
+
+// Open output file and reserve space for the header
+bool BinaryEventSink::open(const string& path) {
+    if (out.is_open()) close();
+    
+    out.open(path, ios::binary | ios::trunc);
+    if (!out) {
+        cout << "Error: Cannot create event file '" << path << "'\n";
+        return false;
+    }
+    
+    uint8_t header[EVENT_HEADER_SIZE] = {};
+    out.write((const char*)header, EVENT_HEADER_SIZE);
+    event_count = 0;
+    return true;
+}
+
+void BinaryEventSink::flushBuffer() {
+    out.write((const char*)buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+// Record layout: type, level, flags, reserved byte, then a, b, c, d as u64
+void BinaryEventSink::emit(const SimEvent& event) {
+    if (!out.is_open()) return;
+    
+    size_t offset = buffer.size();
+    buffer.resize(offset + EVENT_RECORD_SIZE);
+    uint8_t* record = buffer.data() + offset;
+    record[0] = (uint8_t)event.type;
+    record[1] = event.level;
+    record[2] = event.flags;
+    record[3] = 0;
+    storeLE(record + 4, event.a, 8);
+    storeLE(record + 12, event.b, 8);
+    storeLE(record + 20, event.c, 8);
+    storeLE(record + 28, event.d, 8);
+    
+    event_count++;
+    if (buffer.size() >= (1 << 16) - EVENT_RECORD_SIZE) flushBuffer();
+}
+
+// Flush remaining records and write the final header
+bool BinaryEventSink::close() {
+    if (!out.is_open()) return false;
+    flushBuffer();
+    
+    uint8_t header[EVENT_HEADER_SIZE];
+    memcpy(header, EVENT_MAGIC, 4);
+    storeLE(header + 4, EVENT_VERSION, 2);
+    storeLE(header + 6, EVENT_RECORD_SIZE, 2);
+    storeLE(header + 8, event_count, 8);
+    
+    out.seekp(0);
+    out.write((const char*)header, EVENT_HEADER_SIZE);
+    bool ok = (bool)out;
+    out.close();
+    return ok;
+}
@@ -20,14 +20,21 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 
 #include "memory_allocator.h"
 #include "buddy_allocator.h"
 #include "cache_simulator.h"
 #include "virtual_memory_simulator.h"
+#include "trace_format.h"
+#include "belady_oracle.h"
+#include "event_sink.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -59,11 +66,20 @@ private:
     // System configuration
     bool vm_enabled;
     bool cache_enabled;
-    bool verbose;
+    
+    // Event output (text sink reproduces the interactive console output)
+    TextEventSink text_sink;
+    NullEventSink null_sink;
+    BinaryEventSink binary_sink;
+    EventSink* sink;             // Active sink handed to every component
     
     // Physical memory size
     size_t physical_memory_size;
     
+    // Address streams recorded for the OPT comparison (replay ... opt)
+    BeladyOracle* page_oracle;   // Virtual addresses of translated accesses
+    BeladyOracle* line_oracle;   // Physical addresses reaching L1
+    
 public:
     UnifiedMemorySystem()
         : classic_allocator(nullptr),
@@ -73,8 +89,11 @@ public:
           cache_hierarchy(nullptr),
           vm_enabled(false),
           cache_enabled(false),
-          verbose(false),
-          physical_memory_size(0) {}
+          text_sink(cout),
+          sink(&text_sink),
+          physical_memory_size(0),
+          page_oracle(nullptr),
+          line_oracle(nullptr) {}
     
     ~UnifiedMemorySystem() {
         cleanup();
@@ -96,7 +115,8 @@ public:
     // INITIALIZATION
     // ================================================================
     
-    void initializeMemory(size_t size, bool use_buddy_system = false) {
+    void initializeMemory(size_t size, bool use_buddy_system = false,
+                          BuddyBackend buddy_backend = BuddyBackend::FREE_LIST) {
         physical_memory_size = size;
         use_buddy = use_buddy_system;
         
@@ -115,12 +135,14 @@ public:
             
             size_t min_block = 16;  // Default minimum block size
             delete buddy_allocator;
-            buddy_allocator = new BuddyAllocator(size, min_block);
+            buddy_allocator = new BuddyAllocator(size, min_block, buddy_backend);
+            buddy_allocator->setEventSink(sink);
             
             cout << "Memory Allocator: BUDDY SYSTEM\n";
         } else {
             delete classic_allocator;
             classic_allocator = new MemoryManager(size);
+            classic_allocator->setEventSink(sink);
             
             cout << "Memory Allocator: CLASSIC (First/Best/Worst Fit)\n";
         }
@@ -141,6 +163,7 @@ public:
         
         delete vm_simulator;
         vm_simulator = new VirtualMemorySimulator(vm_size, physical_memory_size, page_size, policy);
+        vm_simulator->setEventSink(sink);
         vm_enabled = true;
         
         cout << "Virtual Memory: ENABLED\n";
@@ -148,31 +171,60 @@ public:
         cout << "========================================\n";
     }
     
+    void setTlb(const TlbConfig& config) {
+        if (!vm_enabled || !vm_simulator) {
+            cout << "Error: Virtual memory not initialized!\n";
+            return;
+        }
+        if (!vm_simulator->configureTlb(config)) {
+            cout << "Error: TLB entries and latencies must not be negative, and an L2 TLB needs an L1\n";
+            return;
+        }
+        if (config.l1.lines == 0) {
+            cout << "TLB: OFF\n";
+            return;
+        }
+        cout << "TLB: L1 dTLB " << config.l1.lines << " entries";
+        if (config.l2.lines > 0) cout << ", L2 TLB " << config.l2.lines << " entries";
+        cout << " (latency " << config.l1_latency << "/" << config.l2_latency
+             << ", page walk " << config.walk_latency << " cycles)\n";
+    }
+    
+    // Helper: Build one cache level's configuration from command arguments
+    CacheLevelConfig makeLevelConfig(int lines, int block, string assoc_str, string pol_str, string write_str) {
+        CacheLevelConfig config;
+        config.lines = lines;
+        config.block_size = block;
+        config.associativity = parseAssociativity(assoc_str, config.ways);
+        config.replacement = parseReplacementPolicy(pol_str, config.random_seed);
+        config.write_policy = parseWritePolicy(write_str);
+        return config;
+    }
+    
     void initializeCache(int l1_lines, int l1_block, string l1_assoc_str, string l1_pol_str, string l1_write_str,
                          int l2_lines, int l2_block, string l2_assoc_str, string l2_pol_str, string l2_write_str,
-                         int l3_lines, int l3_block, string l3_assoc_str, string l3_pol_str, string l3_write_str) {  
+                         int l3_lines, int l3_block, string l3_assoc_str, string l3_pol_str, string l3_write_str,
+                         const CacheLatencyConfig& latency = CacheLatencyConfig(),
+                         InclusionPolicy inclusion = InclusionPolicy::NINE) {  
         cout << "\n========================================\n";
         cout << "Initializing Cache Hierarchy\n";
         cout << "========================================\n";
       
-        AssociativityType l1_assoc = parseAssociativity(l1_assoc_str);
-        AssociativityType l2_assoc = parseAssociativity(l2_assoc_str);
-        AssociativityType l3_assoc = parseAssociativity(l3_assoc_str);
-                
-        ReplacementPolicy l1_pol = (l1_pol_str == "fifo") ? ReplacementPolicy::FIFO : ReplacementPolicy::LRU;
-        ReplacementPolicy l2_pol = (l2_pol_str == "fifo") ? ReplacementPolicy::FIFO : ReplacementPolicy::LRU;
-        ReplacementPolicy l3_pol = (l3_pol_str == "fifo") ? ReplacementPolicy::FIFO : ReplacementPolicy::LRU;
+        CacheLevelConfig l1_config = makeLevelConfig(l1_lines, l1_block, l1_assoc_str, l1_pol_str, l1_write_str);
+        CacheLevelConfig l2_config = makeLevelConfig(l2_lines, l2_block, l2_assoc_str, l2_pol_str, l2_write_str);
+        CacheLevelConfig l3_config = makeLevelConfig(l3_lines, l3_block, l3_assoc_str, l3_pol_str, l3_write_str);
         
-        WritePolicy l1_write = parseWritePolicy(l1_write_str);
-        WritePolicy l2_write = parseWritePolicy(l2_write_str);
-        WritePolicy l3_write = parseWritePolicy(l3_write_str);
+        // Inclusion is tracked per block, so every level must use one block size
+        if (inclusion != InclusionPolicy::NINE &&
+            ((l2_lines > 0 && l2_block != l1_block) || (l3_lines > 0 && l3_block != l1_block))) {
+            cout << "Error: " << inclusionPolicyName(inclusion)
+                 << " hierarchies need the same block size at every level\n";
+            return;
+        }
 
         delete cache_hierarchy;
-        cache_hierarchy = new CacheHierarchy(
-            l1_lines, l1_block, l1_assoc, l1_pol, l1_write,
-            l2_lines, l2_block, l2_assoc, l2_pol, l2_write,
-            l3_lines, l3_block, l3_assoc, l3_pol, l3_write
-        );
+        cache_hierarchy = new CacheHierarchy(l1_config, l2_config, l3_config, latency, inclusion);
+        cache_hierarchy->setEventSink(sink);
         cache_enabled = true;
         
         cout << "Cache Hierarchy: ENABLED\n";
@@ -183,6 +235,77 @@ public:
         cout << "========================================\n";
     }
     
+    void setPrefetcher(const string& level_str, const string& type_str, int degree, int distance) {
+        if (!cache_enabled || !cache_hierarchy) {
+            cout << "Error: Cache not initialized!\n";
+            return;
+        }
+        
+        int level = 0;
+        if (level_str == "l1" || level_str == "L1") level = 1;
+        else if (level_str == "l2" || level_str == "L2") level = 2;
+        else if (level_str == "l3" || level_str == "L3") level = 3;
+        
+        if (type_str == "off" || type_str == "none") {
+            if (level == 0) {
+                cout << "Error: Unknown cache level '" << level_str << "'\n";
+                return;
+            }
+            cache_hierarchy->removePrefetcher(level);
+            cout << "Prefetcher on L" << level << ": OFF\n";
+            return;
+        }
+        
+        PrefetchConfig config;
+        if (!parsePrefetchType(type_str, config.type)) {
+            cout << "Error: Unknown prefetcher '" << type_str << "' (use nextline, stride, stream or off)\n";
+            return;
+        }
+        config.degree = degree;
+        config.distance = distance;
+        
+        if (!cache_hierarchy->setPrefetcher(level, config)) {
+            cout << "Error: Cache level '" << level_str << "' does not exist\n";
+            return;
+        }
+        cout << "Prefetcher on L" << level << ": " << type_str
+             << " (degree " << max(1, degree) << ", distance " << max(1, distance) << ")\n";
+    }
+    
+    void setVictimCache(int entries, int hit_latency) {
+        if (!cache_enabled || !cache_hierarchy) {
+            cout << "Error: Cache not initialized!\n";
+            return;
+        }
+        if (!cache_hierarchy->setVictimCache(entries, hit_latency)) {
+            cout << "Error: Victim cache entries and latency must not be negative\n";
+            return;
+        }
+        if (entries == 0) {
+            cout << "Victim cache: OFF\n";
+        } else {
+            cout << "Victim cache: " << entries << " entries behind L1 ("
+                 << hit_latency << (hit_latency == 1 ? " cycle" : " cycles") << " per hit)\n";
+        }
+    }
+    
+    void setMshrs(int entries, uint64_t window) {
+        if (!cache_enabled || !cache_hierarchy) {
+            cout << "Error: Cache not initialized!\n";
+            return;
+        }
+        if (entries < 0) {
+            cout << "Error: MSHR count must not be negative\n";
+            return;
+        }
+        cache_hierarchy->setMshrs(entries, window);
+        if (entries == 0) {
+            cout << "MSHRs: OFF\n";
+        } else {
+            cout << "MSHRs: " << entries << " for L1 misses (merge window " << window << " cycles)\n";
+        }
+    }
+    
     // ================================================================
     // UNIFIED MEMORY ACCESS
     // ================================================================
@@ -192,95 +315,59 @@ public:
      * 1. If VM enabled: Virtual -> Physical translation
      * 2. If Cache enabled: Check cache hierarchy
      * 3. Access physical memory
+     * Returns false if address translation fails. All progress is reported
+     * through the event sink; with no sink attached nothing is formatted.
      */
-    void accessMemory(size_t address, bool is_write = false) {
+    bool accessMemory(size_t address, bool is_write = false) {
         size_t physical_address = address;
+        uint8_t flags = is_write ? EVENT_WRITE : 0;
+        if (vm_enabled && vm_simulator) flags |= EVENT_VM;
+        if (cache_enabled && cache_hierarchy) flags |= EVENT_CACHE;
+        if (use_buddy) flags |= EVENT_BUDDY;
         
-        cout << "\n+==========================================================+\n";
-        cout << "|                  UNIFIED MEMORY ACCESS                   |\n";
-        cout << "+==========================================================+\n";
+        if (sink) sink->emit(SimEvent(SimEventType::ACCESS_BEGIN, address, 0, 0, 0, 0, flags));
         
         // ============================================================
         // STEP 1: VIRTUAL MEMORY (if enabled)
         // ============================================================
         if (vm_enabled && vm_simulator) {
-            cout << "\n  [STEP 1] VIRTUAL MEMORY - Address Translation\n";
-            cout << "  ---------------------------------------------------\n";
-            cout << "  Input: Virtual Address 0x" << hex << address << dec << " (" << address << ")\n";
-            
-            physical_address = vm_simulator->translateAddress(address);
+            physical_address = vm_simulator->translateAddress(address, is_write);
             
             if (physical_address == (size_t)-1) {
-                cout << "\n  [X] Address translation FAILED\n";
-                cout << "  Access terminated.\n";
-                return;
+                if (sink) sink->emit(SimEvent(SimEventType::ACCESS_TRANSLATION_FAILED, address));
+                return false;
             }
             
-            cout << "  [OK] Translation successful\n";
-            cout << "  Output: Physical Address 0x" << hex << physical_address << dec << " (" << physical_address << ")\n";
-        } else {
-            cout << "\n  [STEP 1] VIRTUAL MEMORY: Disabled\n";
-            cout << "  Using direct physical addressing\n";
-            cout << "  Physical Address: 0x" << hex << address << dec << " (" << address << ")\n";
+            if (sink) sink->emit(SimEvent(SimEventType::ACCESS_TRANSLATED, address, physical_address));
+            if (page_oracle) page_oracle->record(address);
         }
         
         // ============================================================
         // STEP 2: CACHE HIERARCHY (if enabled)
         // ============================================================
-        bool all_cache_miss=true;
+        bool all_cache_miss = true;
+        if (sink) {
+            uint8_t levels = 0x1;
+            if (cache_hierarchy && cache_hierarchy->has_l2_level()) levels |= 0x2;
+            if (cache_hierarchy && cache_hierarchy->has_l3_level()) levels |= 0x4;
+            sink->emit(SimEvent(SimEventType::ACCESS_CACHE_BEGIN, address, physical_address, 0, 0, levels, flags));
+        }
         if (cache_enabled && cache_hierarchy) {
-            cout << "\n  [STEP 2] CACHE HIERARCHY - Multi-level Cache Check\n";
-            cout << "  ---------------------------------------------------\n";
-            cout << "  Operation: " << (is_write ? "WRITE" : "READ") << "\n";
-            cout << "  Checking L1";
-            if(cache_hierarchy->has_l2_level()) cout<<" -> L2";
-            if(cache_hierarchy->has_l3_level()) cout<<" -> L3";
-            cout<<" -> Memory...\n\n";
-            
+            if (line_oracle) line_oracle->record(physical_address);
             if (is_write) {
-                all_cache_miss = cache_hierarchy->write(physical_address, verbose);
+                all_cache_miss = cache_hierarchy->write(physical_address);
             } else {
-                all_cache_miss = cache_hierarchy->read(physical_address, verbose);
+                all_cache_miss = cache_hierarchy->read(physical_address);
             }
-        } else {
-            cout << "\n  [STEP 2] CACHE HIERARCHY: Disabled\n";
-            cout << "  Direct memory access\n";
         }
         
         // ============================================================
         // STEP 3: PHYSICAL MEMORY ACCESS
         // ============================================================
-        if (all_cache_miss) {
-            cout << "\n  [STEP 3] PHYSICAL MEMORY - Final Access\n";
-            cout << "  ---------------------------------------------------\n";
-            cout << "  " << (is_write ? "Writing to" : "Reading from") << " physical memory at 0x" << hex << physical_address << dec << "\n";
-            cout << "  Memory allocator: " << (use_buddy ? "Buddy System" : "Classic") << "\n";
-        }
-        
         // Memory is managed by allocator, but actual data access is implicit
-        cout << "\n  [OK] Memory access complete\n";
-        
-        // ============================================================
-        // SUMMARY
-        // ============================================================
-        cout << "\n  +====================================================+\n";
-        cout << "  |                      SUMMARY                       |\n";
-        cout << "  +====================================================+\n";
-        
-        if (vm_enabled) {
-            cout << "  Virtual Address:   0x" << hex << address << dec << " (" << address << ")\n";
-            cout << "  Physical Address:  0x" << hex << physical_address << dec << " (" << physical_address << ")\n";
-        } else {
-            cout << "  Physical Address:  0x" << hex << physical_address << dec << " (" << physical_address << ")\n";
-        }
-        
-        cout << "  Operation: " << (is_write ? "WRITE" : "READ") << "\n";
-        cout << "  Flow: ";
-        if (vm_enabled) cout << "VM Translation -> ";
-        if (cache_enabled) cout << "Cache Hierarchy -> ";
-        if (all_cache_miss) cout << "Physical Memory\n";
-        else cout<<"\n";
-        cout << "  Status: SUCCESS\n\n";
+        if (all_cache_miss) flags |= EVENT_MEMORY;
+        if (sink) sink->emit(SimEvent(SimEventType::ACCESS_END, address, physical_address, 0, 0, 0, flags));
+        return true;
     }
     
     // ================================================================
@@ -288,35 +375,71 @@ public:
     // ================================================================
     
     int allocate(size_t size) {
-        cout << "\n========================================\n";
-        cout << "Memory Allocation Request\n";
-        cout << "========================================\n";
+        if (sink) sink->emit(SimEvent(SimEventType::ALLOC_REQUEST, size));
         
         if (use_buddy && buddy_allocator) {
             return buddy_allocator->allocate(size);
         } else if (classic_allocator) {
             return classic_allocator->allocate(size);
         } else {
-            cout << "Error: No memory allocator initialized!\n";
+            if (sink) sink->emit(SimEvent(SimEventType::NO_ALLOCATOR));
             return -1;
         }
     }
     
     bool deallocate(int block_id) {
-        cout << "\n========================================\n";
-        cout << "Memory Deallocation Request\n";
-        cout << "========================================\n";
+        if (sink) sink->emit(SimEvent(SimEventType::FREE_REQUEST, (uint64_t)(int64_t)block_id));
         
         if (use_buddy && buddy_allocator) {
             return buddy_allocator->deallocate(block_id);
         } else if (classic_allocator) {
             return classic_allocator->deallocate(block_id);
         } else {
-            cout << "Error: No memory allocator initialized!\n";
+            if (sink) sink->emit(SimEvent(SimEventType::NO_ALLOCATOR));
             return false;
         }
     }
     
+    // ================================================================
+    // EVENT OUTPUT
+    // ================================================================
+    
+    // Route events from every component to one sink (nullptr = none)
+    void setEventSink(EventSink* event_sink) {
+        sink = activeSink(event_sink);
+        if (classic_allocator) classic_allocator->setEventSink(sink);
+        if (buddy_allocator) buddy_allocator->setEventSink(sink);
+        if (vm_simulator) vm_simulator->setEventSink(sink);
+        if (cache_hierarchy) cache_hierarchy->setEventSink(sink);
+    }
+    
+    EventSink* getEventSink() const { return sink; }
+    
+    void setEventOutput(const string& mode, const string& path = "") {
+        if (mode == "text") {
+            setEventSink(&text_sink);
+            if (binary_sink.isOpen()) {
+                cout << "Binary event log closed (" << binary_sink.getEventCount() << " events)\n";
+                binary_sink.close();
+            }
+            cout << "Event output: TEXT\n";
+        } else if (mode == "off") {
+            setEventSink(&null_sink);
+            if (binary_sink.isOpen()) {
+                cout << "Binary event log closed (" << binary_sink.getEventCount() << " events)\n";
+                binary_sink.close();
+            }
+            cout << "Event output: OFF\n";
+        } else if (mode == "binary" && !path.empty()) {
+            setEventSink(&null_sink);
+            if (!binary_sink.open(path)) return;
+            setEventSink(&binary_sink);
+            cout << "Event output: BINARY -> " << path << "\n";
+        } else {
+            cout << "Usage: events <text|off|binary <file>>\n";
+        }
+    }
+    
     // ================================================================
     // DISPLAY FUNCTIONS
     // ================================================================
@@ -330,6 +453,9 @@ public:
             cout << "    Type: BUDDY SYSTEM\n";
             cout << "    Size: " << physical_memory_size << " bytes (power-of-2)\n";
             cout << "    Min Block: " << buddy_allocator->getMinBlockSize() << " bytes\n";
+            if (buddy_allocator->getBackend() == BuddyBackend::BITMAP) {
+                cout << "    Backend: Per-order free bitmaps\n";
+            }
         } else if (classic_allocator) {
             cout << "    Type: CLASSIC ALLOCATOR\n";
             cout << "    Size: " << physical_memory_size << " bytes\n";
@@ -368,7 +494,7 @@ public:
         cout << " -> Memory\n";
         
         cout << "\n  Settings:\n";
-        cout << "    Verbose Mode: " << (verbose ? "ON" : "OFF") << "\n";
+        cout << "    Verbose Mode: " << (text_sink.isVerbose() ? "ON" : "OFF") << "\n";
         
         cout << "\n";
     }
@@ -399,6 +525,50 @@ public:
         }
     }
     
+    // Record access streams for the OPT comparison (nullptr stops recording)
+    void setOracles(BeladyOracle* pages, BeladyOracle* lines) {
+        page_oracle = pages;
+        line_oracle = lines;
+    }
+    
+    // FIFO, LRU and OPT misses over the recorded streams, using the
+    // current page-frame and L1 geometry
+    void displayOptComparison(const BeladyOracle& pages, const BeladyOracle& lines) {
+        cout << "\n+--- OPT (BELADY) COMPARISON ----------------------+\n";
+        bool any = false;
+        
+        if (vm_enabled && vm_simulator && pages.size() > 0) {
+            OracleResult result = pages.simulate(vm_simulator->getPageSize(), 1, vm_simulator->getNumFrames());
+            cout << "\nPage faults (" << vm_simulator->getNumFrames() << " frames, "
+                 << vm_simulator->getPageSize() << "-byte pages):\n";
+            printOracleResult(result);
+            any = true;
+        }
+        
+        int sets, ways, block_size;
+        if (cache_enabled && cache_hierarchy && lines.size() > 0 &&
+            cache_hierarchy->levelGeometry(1, sets, ways, block_size)) {
+            OracleResult result = lines.simulate(block_size, sets, ways);
+            cout << "\nL1 misses (" << sets << " sets x " << ways << " ways, "
+                 << block_size << "-byte blocks):\n";
+            printOracleResult(result);
+            any = true;
+        }
+        
+        if (!any) cout << "  No page or L1 accesses recorded\n";
+    }
+    
+    void printOracleResult(const OracleResult& result) {
+        uint64_t counts[3] = { result.fifo_misses, result.lru_misses, result.opt_misses };
+        const char* names[3] = { "FIFO", "LRU ", "OPT " };
+        cout << "  Accesses: " << result.accesses << "\n";
+        for (int i = 0; i < 3; i++) {
+            double rate = (result.accesses > 0) ? (double)counts[i] / result.accesses * 100.0 : 0.0;
+            cout << "  " << names[i] << ": " << setw(10) << counts[i] << " ("
+                 << fixed << setprecision(2) << rate << "%)\n";
+        }
+    }
+    
     void displayMemoryLayout() {
         if (use_buddy && buddy_allocator) {
             buddy_allocator->displayAllocatedBlocks();
@@ -460,9 +630,8 @@ public:
     }
     
     void setVerbose(bool v) {
-        verbose = v;
-        if (vm_simulator) vm_simulator->setVerbose(v);
-        cout << "Verbose mode: " << (verbose ? "ON" : "OFF") << "\n";
+        text_sink.setVerbose(v);
+        cout << "Verbose mode: " << (v ? "ON" : "OFF") << "\n";
     }
     
     void clearAll() {
@@ -516,22 +685,41 @@ void printHelp() {
     cout << "|                         COMMAND REFERENCE                             |\n";
     cout << "+=======================================================================+\n";
     cout << "\n  +- SYSTEM INITIALIZATION ------------------------------------------+\n";
-    cout << "  │ init memory <size> [buddy]                                       │\n";
+    cout << "  │ init memory <size> [buddy [bitmap]]                              │\n";
     cout << "  │   Initialize physical memory allocator                           │\n";
     cout << "  │   Add 'buddy' for buddy system (min block size=16), else classic │\n";
+    cout << "  │   Add 'bitmap' for the O(1) bitmap buddy backend                 │\n";
     cout << "  │   Example: init memory 1024                                      │\n";
     cout << "  │   Example: init memory 1024 buddy                                │\n";
     cout << "  │                                                                  │\n";
     cout << "  │ init vm <vm_size> <page_size> [policy]                           │\n";
-    cout << "  │   Enable virtual memory with paging                              │\n";
-    cout << "  │   policy: fifo (default) or lru                                  │\n";
+    cout << "  │   Enable virtual memory with paging (radix page table, so        │\n";
+    cout << "  │   48-bit spaces like 281474976710656 work)                       │\n";
+    cout << "  │   policy: fifo (default), lru, clock, second_chance,             │\n";
+    cout << "  │           enhanced_clock, aging[:bits] (default 8 bits)          │\n";
     cout << "  │   Example: init vm 65536 256 lru                                 │\n";
     cout << "  │                                                                  │\n";
+    cout << "  │ init tlb <entries> <assoc> <policy> [l2 <entries> <assoc> <pol>] │\n";
+    cout << "  │          [latency <l1> <l2> <walk>]                              │\n";
+    cout << "  │   TLBs in front of the page table (after init vm; 0 = off)       │\n";
+    cout << "  │   Example: init tlb 16 4way lru l2 64 8way lru                   │\n";
+    cout << "  │                                                                  │\n";
     cout << "  │ setup cache                                                      │\n";
     cout << "  │   Interactive cache configuration wizard                         │\n";
     cout << "  │   Guides you step-by-step through L1/L2/L3 cache setup           │\n";
-    cout << "  │   assoc: direct, 2way, 4way, fully                               │\n";
-    cout << "  │   policy: fifo, lru | write: wt (write-through), wb (write-back) │\n";
+    cout << "  │   assoc: direct, <n>way (2way, 8way, ...), fully                 │\n";
+    cout << "  │   policy: fifo, lru, plru, bitplru, srrip, brrip, random[:seed]  │\n";
+    cout << "  │   write: wt (write-through), wb (write-back)                     │\n";
+    cout << "  │                                                                  │\n";
+    cout << "  │ init prefetch <l1|l2|l3> <type> [degree] [distance]              │\n";
+    cout << "  │   Attach a prefetcher to a cache level (after cache setup)       │\n";
+    cout << "  │   type: nextline, stride, stream, off                            │\n";
+    cout << "  │   Example: init prefetch l1 stride 2 1                           │\n";
+    cout << "  │                                                                  │\n";
+    cout << "  │ init victim <entries> [latency]                                  │\n";
+    cout << "  │   Fully associative victim cache behind L1 (0 = off)             │\n";
+    cout << "  │ init mshr <entries> <window>                                     │\n";
+    cout << "  │   L1 MSHRs; misses to a block within window cycles merge         │\n";
     cout << "  +------------------------------------------------------------------+\n";
     cout << "\n  +- MEMORY OPERATIONS ----------------------------------------------+\n";
     cout << "  │ malloc <size>                 Allocate memory                    │\n";
@@ -540,13 +728,18 @@ void printHelp() {
     cout << "  │ write <address>               Write to memory (unified flow)     │\n";
     cout << "  │ access <address>              Access memory (read, unified flow) │\n";
     cout << "  │ dump                          Show memory layout                 │\n";
+    cout << "  │ replay <file>                 Replay a trace quietly, then stats │\n";
+    cout << "  │ replay <file> opt             ...and compare FIFO/LRU with OPT   │\n";
+    cout << "  │ convert_trace <txt> <bin>     Convert text trace to binary       │\n";
     cout << "  +------------------------------------------------------------------+\n";
     cout << "\n  +- CONFIGURATION --------------------------------------------------+\n";
     cout << "  │ set strategy <first_fit|best_fit|worst_fit>                      │\n";
     cout << "  │   (for classic allocator only)                                   │\n";
-    cout << "  │ set vm_policy <fifo|lru>                                         │\n";
+    cout << "  │ set vm_policy <policy>                                           │\n";
+    cout << "  │   fifo, lru, clock, second_chance, enhanced_clock, aging[:bits]  │\n";
     cout << "  │   (if virtual memory enabled)                                    │\n";
     cout << "  │ verbose <on|off>              Toggle detailed output             │\n";
+    cout << "  │ events <text|off|binary <f>>  Choose where events are written    │\n";
     cout << "  +------------------------------------------------------------------+\n";
     cout << "\n  +- INFORMATION & STATISTICS ---------------------------------------+\n";
     cout << "  │ status                        Show system configuration          │\n";
@@ -591,11 +784,11 @@ void setupCacheInteractive(UnifiedMemorySystem& system) {
     getline(cin, input);
     l1_block = input.empty() ? 64 : stoi(input);
     
-    cout << "  Associativity (direct/2way/4way/fully) [default: fully]: ";
+    cout << "  Associativity (direct/<n>way/fully) [default: fully]: ";
     getline(cin, input);
     if (!input.empty()) l1_assoc = input;
     
-    cout << "  Replacement policy (lru/fifo) [default: lru]: ";
+    cout << "  Replacement policy (lru/fifo/plru/bitplru/srrip/brrip/random[:seed]) [default: lru]: ";
     getline(cin, input);
     if (!input.empty()) l1_pol = input;
     
@@ -624,11 +817,11 @@ void setupCacheInteractive(UnifiedMemorySystem& system) {
         getline(cin, input);
         l2_block = input.empty() ? 64 : stoi(input);
         
-        cout << "  Associativity (direct/2way/4way/fully) [default: fully]: ";
+        cout << "  Associativity (direct/<n>way/fully) [default: fully]: ";
         getline(cin, input);
         if (!input.empty()) l2_assoc = input;
         
-        cout << "  Replacement policy (lru/fifo) [default: lru]: ";
+        cout << "  Replacement policy (lru/fifo/plru/bitplru/srrip/brrip/random[:seed]) [default: lru]: ";
         getline(cin, input);
         if (!input.empty()) l2_pol = input;
         
@@ -657,11 +850,11 @@ void setupCacheInteractive(UnifiedMemorySystem& system) {
             getline(cin, input);
             l3_block = input.empty() ? 64 : stoi(input);
             
-            cout << "  Associativity (direct/2way/4way/fully) [default: fully]: ";
+            cout << "  Associativity (direct/<n>way/fully) [default: fully]: ";
             getline(cin, input);
             if (!input.empty()) l3_assoc = input;
             
-            cout << "  Replacement policy (lru/fifo) [default: lru]: ";
+            cout << "  Replacement policy (lru/fifo/plru/bitplru/srrip/brrip/random[:seed]) [default: lru]: ";
             getline(cin, input);
             if (!input.empty()) l3_pol = input;
             
@@ -709,6 +902,8 @@ void setupCacheInteractive(UnifiedMemorySystem& system) {
     }
 }
 
+bool replayTrace(UnifiedMemorySystem& system, const string& path, bool compare_opt = false);
+
 void processCommand(UnifiedMemorySystem& system, const string& line) {
     istringstream iss(line);
     string cmd;
@@ -738,6 +933,11 @@ void processCommand(UnifiedMemorySystem& system, const string& line) {
         iss >> state;
         system.setVerbose(state == "on");
     }
+    else if (cmd == "events") {
+        string mode, path;
+        iss >> mode >> path;
+        system.setEventOutput(mode, path);
+    }
     else if (cmd == "clear") {
         system.clearAll();
     }
@@ -747,10 +947,39 @@ void processCommand(UnifiedMemorySystem& system, const string& line) {
         
         if (type == "memory") {
             size_t size;
-            string mode;
-            iss >> size >> mode;
+            string mode, backend;
+            iss >> size >> mode >> backend;
             bool use_buddy = (mode == "buddy");
-            system.initializeMemory(size, use_buddy);
+            BuddyBackend buddy_backend = (backend == "bitmap") ? BuddyBackend::BITMAP : BuddyBackend::FREE_LIST;
+            system.initializeMemory(size, use_buddy, buddy_backend);
+        }
+        else if (type == "prefetch") {
+            string level_str, type_str;
+            int degree = 1, distance = 1;
+            if (iss >> level_str >> type_str) {
+                iss >> degree >> distance;
+                system.setPrefetcher(level_str, type_str, degree, distance);
+            } else {
+                cout << "Usage: init prefetch <l1|l2|l3> <nextline|stride|stream|off> [degree] [distance]\n";
+            }
+        }
+        else if (type == "victim") {
+            int entries, hit_latency = 1;
+            if (iss >> entries) {
+                iss >> hit_latency;
+                system.setVictimCache(entries, hit_latency);
+            } else {
+                cout << "Usage: init victim <entries> [latency]\n";
+            }
+        }
+        else if (type == "mshr") {
+            int entries;
+            uint64_t window;
+            if (iss >> entries >> window) {
+                system.setMshrs(entries, window);
+            } else {
+                cout << "Usage: init mshr <entries> <window cycles>\n";
+            }
         }
         else if (type == "vm") {
             size_t vm_size, page_size;
@@ -762,6 +991,44 @@ void processCommand(UnifiedMemorySystem& system, const string& line) {
                 cout << "Usage: init vm <vm_size> <page_size> [policy]\n";
             }
         }
+        else if (type == "tlb") {
+            TlbConfig config;
+            string assoc_str, pol_str;
+            if (iss >> config.l1.lines >> assoc_str >> pol_str) {
+                config.l1.associativity = parseAssociativity(assoc_str, config.l1.ways);
+                config.l1.replacement = parseReplacementPolicy(pol_str, config.l1.random_seed);
+                
+                // Optional, in any order:
+                //   l2 <entries> <assoc> <policy>
+                //   latency <l1_hit> <l2_hit> <page_walk>
+                string keyword;
+                while (iss >> keyword) {
+                    if (keyword == "l2") {
+                        if (!(iss >> config.l2.lines >> assoc_str >> pol_str)) {
+                            cout << "Error: expected l2 <entries> <assoc> <policy>\n";
+                            return;
+                        }
+                        config.l2.associativity = parseAssociativity(assoc_str, config.l2.ways);
+                        config.l2.replacement = parseReplacementPolicy(pol_str, config.l2.random_seed);
+                    } else if (keyword == "latency") {
+                        if (!(iss >> config.l1_latency >> config.l2_latency >> config.walk_latency)) {
+                            cout << "Error: expected latency <l1_hit> <l2_hit> <page_walk>\n";
+                            return;
+                        }
+                    } else {
+                        cout << "Error: Unknown TLB option '" << keyword << "'\n";
+                        return;
+                    }
+                }
+                system.setTlb(config);
+            } else {
+                cout << "Usage: init tlb <l1_entries> <l1_assoc> <l1_policy>\n";
+                cout << "                [l2 <entries> <assoc> <policy>]\n";
+                cout << "                [latency <l1_hit> <l2_hit> <page_walk>]\n";
+                cout << "Example: init tlb 16 4way lru l2 64 8way lru latency 1 7 30\n";
+                cout << "  (use l1_entries=0 to remove the TLBs)\n";
+            }
+        }
         else if (type == "cache") {
             int l1_lines, l1_block, l2_lines, l2_block, l3_lines, l3_block;
             string l1_assoc_str, l1_pol_str, l1_write_str;
@@ -771,15 +1038,42 @@ void processCommand(UnifiedMemorySystem& system, const string& line) {
             if (iss >> l1_lines >> l1_block >> l1_assoc_str >> l1_pol_str >> l1_write_str
                     >> l2_lines >> l2_block >> l2_assoc_str >> l2_pol_str >> l2_write_str
                     >> l3_lines >> l3_block >> l3_assoc_str >> l3_pol_str >> l3_write_str) {
+                // Optional, in any order:
+                //   latency <l1_hit> <l1_miss> <l2_hit> <l2_miss> <l3_hit> <l3_miss> <memory>
+                //   inclusion <nine|inclusive|exclusive>
+                CacheLatencyConfig latency;
+                InclusionPolicy inclusion = InclusionPolicy::NINE;
+                string keyword;
+                while (iss >> keyword) {
+                    if (keyword == "latency") {
+                        if (!(iss >> latency.hit[0] >> latency.miss[0] >> latency.hit[1] >> latency.miss[1]
+                                  >> latency.hit[2] >> latency.miss[2] >> latency.memory)) {
+                            cout << "Error: expected latency <l1_hit> <l1_miss> <l2_hit> <l2_miss> <l3_hit> <l3_miss> <memory>\n";
+                            return;
+                        }
+                    } else if (keyword == "inclusion") {
+                        string policy_str;
+                        if (!(iss >> policy_str) || !parseInclusionPolicy(policy_str, inclusion)) {
+                            cout << "Error: expected inclusion <nine|inclusive|exclusive>\n";
+                            return;
+                        }
+                    } else {
+                        cout << "Error: Unknown cache option '" << keyword << "'\n";
+                        return;
+                    }
+                }
                 system.initializeCache(
                     l1_lines, l1_block, l1_assoc_str, l1_pol_str, l1_write_str,
                     l2_lines, l2_block, l2_assoc_str, l2_pol_str, l2_write_str,
-                    l3_lines, l3_block, l3_assoc_str, l3_pol_str, l3_write_str
+                    l3_lines, l3_block, l3_assoc_str, l3_pol_str, l3_write_str,
+                    latency, inclusion
                 );
             } else {
                 cout << "Usage: init cache <l1_lines> <l1_block> <l1_assoc> <l1_pol> <l1_write>\n";
                 cout << "                  <l2_lines> <l2_block> <l2_assoc> <l2_pol> <l2_write>\n";
                 cout << "                  <l3_lines> <l3_block> <l3_assoc> <l3_pol> <l3_write>\n";
+                cout << "                  [latency <l1_hit> <l1_miss> <l2_hit> <l2_miss> <l3_hit> <l3_miss> <memory>]\n";
+                cout << "                  [inclusion <nine|inclusive|exclusive>]\n";
                 cout << "Example: init cache 8 64 2way lru wt 16 64 2way lru wb 32 64 2way lru wb\n";
                 cout << "  (use l3_lines=0 to skip L3)\n";
             }
@@ -843,6 +1137,23 @@ void processCommand(UnifiedMemorySystem& system, const string& line) {
     else if (cmd == "dump") {
         system.displayMemoryLayout();
     }
+    else if (cmd == "convert_trace") {
+        string text_path, binary_path;
+        if (iss >> text_path >> binary_path) {
+            convertTextTrace(text_path, binary_path);
+        } else {
+            cout << "Usage: convert_trace <text_trace> <binary_trace>\n";
+        }
+    }
+    else if (cmd == "replay") {
+        string path, mode;
+        if (iss >> path) {
+            iss >> mode;
+            replayTrace(system, path, mode == "opt");
+        } else {
+            cout << "Usage: replay <trace_file> [opt]\n";
+        }
+    }
     else if (cmd == "page_table") {
         system.displayPageTable();
     }
@@ -854,14 +1165,196 @@ void processCommand(UnifiedMemorySystem& system, const string& line) {
     }
 }
 
+// ================================================================
+// TRACE REPLAY
+// ================================================================
+
+// Stream buffer that swallows everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct ReplayStats {
+    long long records;
+    long long reads;
+    long long writes;
+    long long allocations;
+    long long frees;
+    long long commands;      // Non-access lines handed to processCommand
+    long long failures;      // Failed translations/allocations/frees, bad operands
+};
+
+// Helper: Compare a token against a keyword
+static bool tokenIs(const char* token, size_t len, const char* keyword) {
+    return strlen(keyword) == len && memcmp(token, keyword, len) == 0;
+}
+
+// Run one access/alloc/free record (no event sink attached during replay)
+static void applyTraceOp(UnifiedMemorySystem& system, TraceOp op, uint64_t value, ReplayStats& stats) {
+    switch (op) {
+        case TraceOp::READ:
+        case TraceOp::WRITE:
+            if (op == TraceOp::WRITE) stats.writes++; else stats.reads++;
+            if (!system.accessMemory((size_t)value, op == TraceOp::WRITE)) stats.failures++;
+            break;
+        case TraceOp::MALLOC:
+            stats.allocations++;
+            if (system.allocate((size_t)value) == -1) stats.failures++;
+            break;
+        case TraceOp::FREE:
+            stats.frees++;
+            if (!system.deallocate((int)value)) stats.failures++;
+            break;
+        case TraceOp::COMMAND:
+            break;
+    }
+}
+
+// Text workload: streamed line by line and tokenised in place
+static void replayTextTrace(UnifiedMemorySystem& system, ifstream& in, ReplayStats& stats) {
+    string line;
+    while (getline(in, line)) {
+        const char* p = line.c_str();
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\0' || *p == '\r' || *p == '#') continue;
+        
+        const char* token = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r') p++;
+        size_t len = p - token;
+        
+        if (tokenIs(token, len, "exit") || tokenIs(token, len, "quit")) break;
+        stats.records++;
+        
+        TraceOp op;
+        if (tokenIs(token, len, "read") || tokenIs(token, len, "access")) op = TraceOp::READ;
+        else if (tokenIs(token, len, "write")) op = TraceOp::WRITE;
+        else if (tokenIs(token, len, "malloc")) op = TraceOp::MALLOC;
+        else if (tokenIs(token, len, "free")) op = TraceOp::FREE;
+        else {
+            stats.commands++;
+            processCommand(system, line);
+            continue;
+        }
+        
+        char* end;
+        long long value = strtoll(p, &end, 10);
+        if (end == p || value < 0) {
+            stats.failures++;
+            continue;
+        }
+        applyTraceOp(system, op, (uint64_t)value, stats);
+    }
+}
+
+// Binary trace: records decoded straight out of the memory-mapped file
+static void replayBinaryTrace(UnifiedMemorySystem& system, BinaryTraceReader& reader, ReplayStats& stats) {
+    TraceRecord record;
+    while (reader.next(record)) {
+        stats.records++;
+        if (record.op == TraceOp::COMMAND) {
+            stats.commands++;
+            processCommand(system, string(record.text, record.text_length));
+        } else {
+            applyTraceOp(system, record.op, record.value, stats);
+        }
+    }
+}
+
+/**
+ * Streams a trace through the system. Text traces use the interactive
+ * command syntax; binary traces (see trace_format.h) are detected by
+ * their magic number and memory-mapped. The event sink is detached for
+ * the duration, so read/write/access/malloc/free produce no output at
+ * all; any other command runs normally with its console output
+ * discarded. Only the replay summary and final statistics print.
+ * With compare_opt the page and L1 address streams are recorded and
+ * replayed offline under FIFO, LRU and Belady's OPT afterwards.
+ */
+bool replayTrace(UnifiedMemorySystem& system, const string& path, bool compare_opt) {
+    bool binary = isBinaryTrace(path);
+    ifstream text_in;
+    BinaryTraceReader reader;
+    
+    if (binary) {
+        if (!reader.open(path)) return false;
+    } else {
+        text_in.open(path);
+        if (!text_in) {
+            cout << "Error: Cannot open trace file '" << path << "'\n";
+            return false;
+        }
+    }
+    
+    ReplayStats stats = {};
+    BeladyOracle page_oracle, line_oracle;
+    if (compare_opt) system.setOracles(&page_oracle, &line_oracle);
+    NullEventSink null_events;
+    EventSink* saved_sink = system.getEventSink();
+    system.setEventSink(&null_events);
+    NullBuffer null_buffer;
+    streambuf* saved = cout.rdbuf(&null_buffer);
+    auto start = chrono::steady_clock::now();
+    
+    if (binary) {
+        replayBinaryTrace(system, reader, stats);
+    } else {
+        replayTextTrace(system, text_in, stats);
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(saved);
+    system.setEventSink(saved_sink);
+    system.setOracles(nullptr, nullptr);
+    
+    cout << "\n+==========================================================+\n";
+    cout << "|                      TRACE REPLAY                        |\n";
+    cout << "+==========================================================+\n";
+    cout << "  Trace file: " << path << (binary ? " (binary)" : " (text)") << "\n";
+    cout << "  Records: " << stats.records << "\n";
+    cout << "  Reads: " << stats.reads << ", Writes: " << stats.writes << "\n";
+    cout << "  Allocations: " << stats.allocations << ", Frees: " << stats.frees << "\n";
+    cout << "  Other commands: " << stats.commands << "\n";
+    cout << "  Failed operations: " << stats.failures << "\n";
+    if (binary && reader.isCorrupt()) {
+        cout << "  Warning: trace is truncated or corrupt after record " << reader.getRecordsRead() << "\n";
+    }
+    cout << "  Elapsed: " << fixed << setprecision(3) << seconds << " s";
+    if (seconds > 0) {
+        cout << " (" << setprecision(0) << (stats.records / seconds) << " records/sec)";
+    }
+    cout << "\n";
+    
+    system.displayAllStats();
+    if (compare_opt) system.displayOptComparison(page_oracle, line_oracle);
+    return true;
+}
+
 // ================================================================
 // MAIN
 // ================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
     setupConsole();
     
     UnifiedMemorySystem system;
+    
+    // Batch modes: memsim --trace <file> | memsim --convert <text> <binary>
+    if (argc > 1) {
+        string option = argv[1];
+        if (option == "--trace" && argc > 2) {
+            bool compare_opt = (argc > 3 && string(argv[3]) == "--opt");
+            return replayTrace(system, argv[2], compare_opt) ? 0 : 1;
+        }
+        if (option == "--convert" && argc > 3) {
+            return convertTextTrace(argv[2], argv[3]) ? 0 : 1;
+        }
+        cout << "Usage: " << argv[0] << " [--trace <trace_file> [--opt]]\n";
+        cout << "       " << argv[0] << " [--convert <text_trace> <binary_trace>]\n";
+        return 1;
+    }
+    
     printWelcome();
     
     string line;
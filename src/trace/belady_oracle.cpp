@@ -0,0 +1,119 @@
+#include <vector>
+#include <list>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include "belady_oracle.h"
+
+using namespace std;
+
+// Next-use index of an entry that is never touched again
+static const size_t NEVER = SIZE_MAX;
+
+// ==================== BELADY ORACLE IMPLEMENTATION ====================
+
+// Helper: next_use[i] = index of the next access to keys[i] (NEVER if none),
+// from one backward pass
+void BeladyOracle::computeNextUse(const vector<uint64_t>& keys, vector<size_t>& next_use) const {
+    next_use.assign(keys.size(), NEVER);
+    unordered_map<uint64_t, size_t> seen_at;
+    seen_at.reserve(keys.size());
+    
+    for (size_t i = keys.size(); i-- > 0;) {
+        auto it = seen_at.find(keys[i]);
+        if (it != seen_at.end()) {
+            next_use[i] = it->second;
+            it->second = i;
+        } else {
+            seen_at.emplace(keys[i], i);
+        }
+    }
+}
+
+// Helper: OPT misses. Each set keeps a max-heap of (next use, key); a hit
+// pushes the key's new next use and leaves the old pair behind, so stale
+// pairs are skipped when they surface at eviction time.
+uint64_t BeladyOracle::simulateOpt(const vector<uint64_t>& keys, int sets, int ways) const {
+    vector<size_t> next_use;
+    computeNextUse(keys, next_use);
+    
+    vector<priority_queue<pair<size_t, uint64_t>>> heaps(sets);
+    vector<int> used(sets, 0);
+    unordered_map<uint64_t, size_t> resident;   // Key -> its current next use
+    uint64_t misses = 0;
+    
+    for (size_t i = 0; i < keys.size(); i++) {
+        uint64_t key = keys[i];
+        int set = (int)(key % sets);
+        auto& heap = heaps[set];
+        
+        auto it = resident.find(key);
+        if (it != resident.end()) {
+            it->second = next_use[i];
+            heap.push(make_pair(next_use[i], key));
+            continue;
+        }
+        
+        misses++;
+        if (used[set] == ways) {
+            while (true) {
+                pair<size_t, uint64_t> top = heap.top();
+                heap.pop();
+                auto victim = resident.find(top.second);
+                if (victim != resident.end() && victim->second == top.first) {
+                    resident.erase(victim);
+                    used[set]--;
+                    break;
+                }
+            }
+        }
+        resident.emplace(key, next_use[i]);
+        heap.push(make_pair(next_use[i], key));
+        used[set]++;
+    }
+    return misses;
+}
+
+// Helper: FIFO (move_on_hit = false) or LRU misses; each set's list runs
+// from the next victim at the front to the newest entry at the back
+uint64_t BeladyOracle::simulateQueue(const vector<uint64_t>& keys, int sets, int ways, bool move_on_hit) const {
+    vector<list<uint64_t>> queues(sets);
+    unordered_map<uint64_t, list<uint64_t>::iterator> position;
+    uint64_t misses = 0;
+    
+    for (uint64_t key : keys) {
+        list<uint64_t>& queue = queues[key % sets];
+        
+        auto it = position.find(key);
+        if (it != position.end()) {
+            if (move_on_hit) queue.splice(queue.end(), queue, it->second);
+            continue;
+        }
+        
+        misses++;
+        if ((int)queue.size() == ways) {
+            position.erase(queue.front());
+            queue.pop_front();
+        }
+        position[key] = queue.insert(queue.end(), key);
+    }
+    return misses;
+}
+
+// Misses of a sets x ways cache over the recorded stream
+OracleResult BeladyOracle::simulate(uint64_t unit, int sets, int ways) const {
+    OracleResult result;
+    if (unit == 0 || sets < 1 || ways < 1) return result;
+    
+    vector<uint64_t> keys;
+    keys.reserve(addresses.size());
+    for (uint64_t address : addresses) {
+        keys.push_back(address / unit);
+    }
+    
+    result.accesses = keys.size();
+    result.fifo_misses = simulateQueue(keys, sets, ways, false);
+    result.lru_misses = simulateQueue(keys, sets, ways, true);
+    result.opt_misses = simulateOpt(keys, sets, ways);
+    return result;
+}
@@ -0,0 +1,377 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include "trace_format.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ==================== ENCODING HELPERS ====================
+
+// Helper: Map signed deltas onto unsigned values (small magnitude -> small value)
+static uint64_t zigzagEncode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t zigzagDecode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// Helper: Write a little-endian integer into a byte array
+static void storeLE(uint8_t* dst, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t loadLE(const uint8_t* src, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint64_t)src[i] << (8 * i);
+    }
+    return value;
+}
+
+// ==================== BINARY TRACE WRITER ====================
+
+BinaryTraceWriter::BinaryTraceWriter() : record_count(0), previous_address(0) {
+    buffer.reserve(1 << 16);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter() {
+    if (out.is_open()) close();
+}
+
+// Open output file and reserve space for the header
+bool BinaryTraceWriter::open(const string& path) {
+    out.open(path, ios::binary | ios::trunc);
+    if (!out) {
+        cout << "Error: Cannot create trace file '" << path << "'\n";
+        return false;
+    }
+    
+    uint8_t header[TRACE_HEADER_SIZE] = {};
+    out.write((const char*)header, TRACE_HEADER_SIZE);
+    record_count = 0;
+    previous_address = 0;
+    return true;
+}
+
+// Append an unsigned LEB128 varint
+void BinaryTraceWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((uint8_t)value);
+}
+
+void BinaryTraceWriter::flushBuffer() {
+    out.write((const char*)buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+void BinaryTraceWriter::writeAccess(bool is_write, uint64_t address, bool has_pid, uint32_t pid) {
+    TraceOp op = is_write ? TraceOp::WRITE : TraceOp::READ;
+    buffer.push_back((uint8_t)op | (has_pid ? TRACE_HAS_PID : 0));
+    putVarint(zigzagEncode((int64_t)(address - previous_address)));
+    if (has_pid) putVarint(pid);
+    previous_address = address;
+    record_count++;
+    if (buffer.size() >= (1 << 16) - 32) flushBuffer();
+}
+
+void BinaryTraceWriter::writeMalloc(uint64_t size, bool has_pid, uint32_t pid) {
+    buffer.push_back((uint8_t)TraceOp::MALLOC | (has_pid ? TRACE_HAS_PID : 0));
+    putVarint(size);
+    if (has_pid) putVarint(pid);
+    record_count++;
+    if (buffer.size() >= (1 << 16) - 32) flushBuffer();
+}
+
+void BinaryTraceWriter::writeFree(uint64_t block_id, bool has_pid, uint32_t pid) {
+    buffer.push_back((uint8_t)TraceOp::FREE | (has_pid ? TRACE_HAS_PID : 0));
+    putVarint(block_id);
+    if (has_pid) putVarint(pid);
+    record_count++;
+    if (buffer.size() >= (1 << 16) - 32) flushBuffer();
+}
+
+void BinaryTraceWriter::writeCommand(const string& text) {
+    buffer.push_back((uint8_t)TraceOp::COMMAND);
+    putVarint(text.size());
+    buffer.insert(buffer.end(), text.begin(), text.end());
+    record_count++;
+    if (buffer.size() >= (1 << 16) - 32) flushBuffer();
+}
+
+// Flush remaining records and write the final header
+bool BinaryTraceWriter::close() {
+    flushBuffer();
+    
+    uint8_t header[TRACE_HEADER_SIZE];
+    memcpy(header, TRACE_MAGIC, 4);
+    storeLE(header + 4, TRACE_VERSION, 2);
+    storeLE(header + 6, 0, 2);
+    storeLE(header + 8, record_count, 8);
+    
+    out.seekp(0);
+    out.write((const char*)header, TRACE_HEADER_SIZE);
+    bool ok = (bool)out;
+    out.close();
+    return ok;
+}
+
+// ==================== BINARY TRACE READER ====================
+
+BinaryTraceReader::BinaryTraceReader()
+    : data(nullptr), size(0), cursor(nullptr), record_count(0),
+      records_read(0), previous_address(0), corrupt(false),
+#ifdef _WIN32
+      file_handle(nullptr), mapping_handle(nullptr) {}
+#else
+      fd(-1) {}
+#endif
+
+BinaryTraceReader::~BinaryTraceReader() {
+    close();
+}
+
+// Map the whole file read-only and validate the header
+bool BinaryTraceReader::open(const string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        cout << "Error: Cannot open trace file '" << path << "'\n";
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    size = (size_t)file_size.QuadPart;
+    file_handle = file;
+    
+    if (size >= TRACE_HEADER_SIZE) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            mapping_handle = mapping;
+            data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cout << "Error: Cannot open trace file '" << path << "'\n";
+        return false;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    size = (size_t)st.st_size;
+    
+    if (size >= TRACE_HEADER_SIZE) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            data = (const uint8_t*)mapped;
+            madvise(mapped, size, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+
+    if (data == nullptr || memcmp(data, TRACE_MAGIC, 4) != 0 ||
+        loadLE(data + 4, 2) != TRACE_VERSION) {
+        cout << "Error: '" << path << "' is not a version " << TRACE_VERSION << " binary trace\n";
+        close();
+        return false;
+    }
+    
+    record_count = loadLE(data + 8, 8);
+    cursor = data + TRACE_HEADER_SIZE;
+    records_read = 0;
+    previous_address = 0;
+    corrupt = false;
+    return true;
+}
+
+// Read an unsigned LEB128 varint, bounds-checked against the mapping
+bool BinaryTraceReader::getVarint(uint64_t& value) {
+    const uint8_t* end = data + size;
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// Decode the next record
+bool BinaryTraceReader::next(TraceRecord& record) {
+    if (data == nullptr || records_read >= record_count || cursor >= data + size) {
+        return false;
+    }
+    
+    uint8_t tag = *cursor++;
+    record.op = (TraceOp)(tag & TRACE_OP_MASK);
+    record.has_pid = (tag & TRACE_HAS_PID) != 0;
+    record.text = nullptr;
+    record.text_length = 0;
+    
+    uint64_t payload;
+    if (!getVarint(payload)) {
+        corrupt = true;
+        return false;
+    }
+    
+    switch (record.op) {
+        case TraceOp::READ:
+        case TraceOp::WRITE:
+            previous_address += (uint64_t)zigzagDecode(payload);
+            record.value = previous_address;
+            break;
+        case TraceOp::MALLOC:
+        case TraceOp::FREE:
+            record.value = payload;
+            break;
+        case TraceOp::COMMAND:
+            if (payload > (uint64_t)(data + size - cursor)) {
+                corrupt = true;
+                return false;
+            }
+            record.text = (const char*)cursor;
+            record.text_length = (size_t)payload;
+            cursor += payload;
+            break;
+        default:
+            corrupt = true;
+            return false;
+    }
+    
+    if (record.has_pid) {
+        uint64_t pid;
+        if (!getVarint(pid)) {
+            corrupt = true;
+            return false;
+        }
+        record.pid = (uint32_t)pid;
+    }
+    
+    records_read++;
+    return true;
+}
+
+// Unmap and close
+void BinaryTraceReader::close() {
+#ifdef _WIN32
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mapping_handle != nullptr) CloseHandle((HANDLE)mapping_handle);
+    if (file_handle != nullptr) CloseHandle((HANDLE)file_handle);
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+#else
+    if (data != nullptr) munmap((void*)data, size);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    cursor = nullptr;
+    size = 0;
+}
+
+// ==================== HELPER FUNCTIONS ====================
+
+// Check whether a file starts with the binary trace magic
+bool isBinaryTrace(const string& path) {
+    ifstream in(path, ios::binary);
+    char magic[4];
+    if (!in.read(magic, 4)) return false;
+    return memcmp(magic, TRACE_MAGIC, 4) == 0;
+}
+
+// Helper: Parse an unsigned decimal token; advances p past it
+static bool parseUnsigned(const char*& p, uint64_t& value) {
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p < '0' || *p > '9') return false;
+    char* end;
+    value = strtoull(p, &end, 10);
+    p = end;
+    return true;
+}
+
+/**
+ * Converts a text workload (interactive command syntax) into the binary
+ * format. read/access/write/malloc/free become compact records with an
+ * optional trailing pid ("read 4096 2"); other lines are kept verbatim
+ * as COMMAND records so the binary trace stays self-contained.
+ */
+bool convertTextTrace(const string& text_path, const string& binary_path) {
+    ifstream in(text_path);
+    if (!in) {
+        cout << "Error: Cannot open trace file '" << text_path << "'\n";
+        return false;
+    }
+    
+    BinaryTraceWriter writer;
+    if (!writer.open(binary_path)) return false;
+    
+    uint64_t text_bytes = 0;
+    string line;
+    while (getline(in, line)) {
+        text_bytes += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        
+        const char* p = line.c_str();
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\0' || *p == '#') continue;
+        
+        const char* token = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t') p++;
+        string op(token, p - token);
+        
+        if (op == "exit" || op == "quit") break;
+        
+        bool is_read = (op == "read" || op == "access");
+        bool is_write = (op == "write");
+        bool is_malloc = (op == "malloc");
+        bool is_free = (op == "free");
+        
+        uint64_t value, pid = 0;
+        if ((is_read || is_write || is_malloc || is_free) && parseUnsigned(p, value)) {
+            bool has_pid = parseUnsigned(p, pid);
+            if (is_malloc) {
+                writer.writeMalloc(value, has_pid, (uint32_t)pid);
+            } else if (is_free) {
+                writer.writeFree(value, has_pid, (uint32_t)pid);
+            } else {
+                writer.writeAccess(is_write, value, has_pid, (uint32_t)pid);
+            }
+        } else {
+            writer.writeCommand(string(token));
+        }
+    }
+    
+    uint64_t records = writer.getRecordCount();
+    if (!writer.close()) {
+        cout << "Error: Failed writing trace file '" << binary_path << "'\n";
+        return false;
+    }
+    
+    ifstream check(binary_path, ios::binary | ios::ate);
+    uint64_t binary_bytes = (uint64_t)check.tellg();
+    
+    cout << "Converted " << records << " records: " << text_path << " (" << text_bytes
+         << " bytes) -> " << binary_path << " (" << binary_bytes << " bytes)\n";
+    return true;
+}
@@ -9,6 +9,18 @@
 
 using namespace std;
 
+// frame_to_page value of a free frame
+static const uint64_t NO_PAGE = UINT64_MAX;
+
+// Page-number bits indexed by each non-root table (512 entries)
+static const int TABLE_BITS = 9;
+
+// Modelled size of one page-table entry
+static const uint64_t PTE_BYTES = 8;
+
+// Larger spaces list only resident pages in displayPageTable
+static const uint64_t PAGE_TABLE_DISPLAY_LIMIT = 1024;
+
 // ==================== VIRTUAL MEMORY SIMULATOR ====================
 
 VirtualMemorySimulator::VirtualMemorySimulator(size_t vm_size, size_t pm_size, size_t pg_size, string policy_str)
@@ -21,30 +33,44 @@ VirtualMemorySimulator::VirtualMemorySimulator(size_t vm_size, size_t pm_size, s
         disk_reads(0),
         disk_writes(0),
         current_time(0),
-        verbose(false) {
+        hand_movements(0),
+        levels_walked(0),
+        l1_tlb(nullptr),
+        l2_tlb(nullptr),
+        tlb_lookups(0),
+        l1_tlb_hits(0),
+        l2_tlb_hits(0),
+        page_walks(0),
+        translation_cycles(0),
+        sink(nullptr) {
     
     // Calculate number of pages and frames
     num_virtual_pages = virtual_memory_size / page_size;
     num_physical_frames = physical_memory_size / page_size;
     
     // Validate configuration
-    if (num_physical_frames > num_virtual_pages) {
+    if ((uint64_t)num_physical_frames > num_virtual_pages) {
         cout << "Warning: Physical memory larger than virtual memory!\n";
         num_physical_frames = num_virtual_pages;
         physical_memory_size = num_physical_frames * page_size;
     }
     
-    // Initialize page table
-    page_table.resize(num_virtual_pages);
+    // Radix geometry: enough levels of 9 bits to cover every page number
+    int page_bits = 0;
+    while (page_bits < 64 && (uint64_t(1) << page_bits) < num_virtual_pages) page_bits++;
+    page_table_levels = max(1, (page_bits + TABLE_BITS - 1) / TABLE_BITS);
+    root_bits = page_bits - TABLE_BITS * (page_table_levels - 1);
+    
+    // Initialize page table (just the empty root)
+    resetPageTable();
     
     // Initialize frame tracking
-    frame_to_page.resize(num_physical_frames, -1);
-    frame_used.resize(num_physical_frames, false);
+    resetFrames();
     
-    // Set replacement policy
-    if (policy_str == "lru") {
-        policy = PageReplacementPolicy::LRU;
-    } else {
+    // Set replacement policy (unknown names fall back to FIFO)
+    aging_bits = 8;
+    clock_hand = 0;
+    if (!parsePageReplacementPolicy(policy_str, policy, aging_bits)) {
         policy = PageReplacementPolicy::FIFO;
     }
     
@@ -54,70 +80,237 @@ VirtualMemorySimulator::VirtualMemorySimulator(size_t vm_size, size_t pm_size, s
     cout << "Page size: " << page_size << " bytes\n";
     cout << "Virtual pages: " << num_virtual_pages << "\n";
     cout << "Physical frames: " << num_physical_frames << "\n";
-    cout << "Replacement policy: " << (policy == PageReplacementPolicy::FIFO ? "FIFO" : "LRU") << "\n";
+    cout << "Replacement policy: " << policyLabel() << "\n";
     cout << "==========================================\n\n";
 }
 
+VirtualMemorySimulator::~VirtualMemorySimulator() {
+    delete l1_tlb;
+    delete l2_tlb;
+}
+
+// Helper: Drop every table but a fresh, empty root
+void VirtualMemorySimulator::resetPageTable() {
+    page_table.clear();
+    page_table_entries = 0;
+    allocateTable(0);
+}
+
+// Helper: Append an empty table for the given level; returns its node
+int VirtualMemorySimulator::allocateTable(int level) {
+    size_t entries = (size_t)1 << (level == 0 ? root_bits : TABLE_BITS);
+    page_table.emplace_back();
+    PageTableNode& node = page_table.back();
+    if (level == page_table_levels - 1) {
+        node.entries.assign(entries, PageTableEntry());
+    } else {
+        node.children.assign(entries, -1);
+    }
+    page_table_entries += entries;
+    return (int)page_table.size() - 1;
+}
+
+// Helper: Entry a page number selects in a table at the given level
+int VirtualMemorySimulator::tableIndex(uint64_t page_number, int level) const {
+    int shift = TABLE_BITS * (page_table_levels - 1 - level);
+    int bits = (level == 0) ? root_bits : TABLE_BITS;
+    return (int)((page_number >> shift) & ((uint64_t(1) << bits) - 1));
+}
+
+// Helper: Walk the tables to a page's entry, one step per level. Missing
+// tables are created if allocate is set; otherwise the result is nullptr.
+PageTableEntry* VirtualMemorySimulator::findEntry(uint64_t page_number, bool allocate) {
+    int node = 0;
+    for (int level = 0; level < page_table_levels - 1; level++) {
+        int index = tableIndex(page_number, level);
+        int child = page_table[node].children[index];
+        if (child == -1) {
+            if (!allocate) return nullptr;
+            child = allocateTable(level + 1);
+            page_table[node].children[index] = child;
+        }
+        node = child;
+    }
+    return &page_table[node].entries[tableIndex(page_number, page_table_levels - 1)];
+}
+
+// Helper: Mark every frame free and empty the resident-page lists
+void VirtualMemorySimulator::resetFrames() {
+    frame_to_page.assign(num_physical_frames, NO_PAGE);
+    frame_to_pte.assign(num_physical_frames, nullptr);
+    
+    free_frame_bits.assign((num_physical_frames + 63) / 64, ~uint64_t(0));
+    if (num_physical_frames % 64 != 0) {
+        free_frame_bits.back() = (uint64_t(1) << (num_physical_frames % 64)) - 1;
+    }
+    free_frames = num_physical_frames;
+    free_word_hint = 0;
+    
+    for (FrameList* list : { &load_order, &recency_order }) {
+        list->prev.assign(num_physical_frames, -1);
+        list->next.assign(num_physical_frames, -1);
+        list->head = -1;
+        list->tail = -1;
+    }
+}
+
+// Helper: Update a frame's bit in the free-frame bitmap
+void VirtualMemorySimulator::setFrameFree(int frame, bool free) {
+    uint64_t bit = uint64_t(1) << (frame % 64);
+    if (free) {
+        free_frame_bits[frame / 64] |= bit;
+        free_frames++;
+        free_word_hint = min(free_word_hint, frame / 64);
+    } else {
+        free_frame_bits[frame / 64] &= ~bit;
+        free_frames--;
+    }
+}
+
+// Helper: Append a frame at the tail (newest end) of a list
+void VirtualMemorySimulator::linkFrame(FrameList& list, int frame) {
+    list.prev[frame] = list.tail;
+    list.next[frame] = -1;
+    if (list.tail != -1) {
+        list.next[list.tail] = frame;
+    } else {
+        list.head = frame;
+    }
+    list.tail = frame;
+}
+
+// Helper: Remove a frame from a list
+void VirtualMemorySimulator::unlinkFrame(FrameList& list, int frame) {
+    int prev = list.prev[frame];
+    int next = list.next[frame];
+    if (prev != -1) list.next[prev] = next; else list.head = next;
+    if (next != -1) list.prev[next] = prev; else list.tail = prev;
+    list.prev[frame] = -1;
+    list.next[frame] = -1;
+}
+
 // Set replacement policy
 void VirtualMemorySimulator::setReplacementPolicy(string policy_str) {
-    if (policy_str == "lru") {
-        policy = PageReplacementPolicy::LRU;
-        cout << "Replacement policy set to: LRU\n";
-    } else if (policy_str == "fifo") {
-        policy = PageReplacementPolicy::FIFO;
-        cout << "Replacement policy set to: FIFO\n";
-    } else {
-        cout << "Unknown policy. Available: fifo, lru\n";
+    PageReplacementPolicy parsed;
+    int bits = aging_bits;
+    if (!parsePageReplacementPolicy(policy_str, parsed, bits)) {
+        cout << "Unknown policy. Available: fifo, lru, clock, second_chance, enhanced_clock, aging[:bits]\n";
+        return;
+    }
+    policy = parsed;
+    aging_bits = bits;
+    cout << "Replacement policy set to: " << policyLabel() << "\n";
+}
+
+// Helper: Policy name for display, with the aging register width
+string VirtualMemorySimulator::policyLabel() const {
+    string label = pageReplacementPolicyName(policy);
+    if (policy == PageReplacementPolicy::AGING) {
+        label += " (" + to_string(aging_bits) + "-bit)";
     }
+    return label;
 }
 
-// Enable/disable verbose mode
-void VirtualMemorySimulator::setVerbose(bool v) {
-    verbose = v;
+// Attach an event sink (nullptr or a NullEventSink disables reporting)
+void VirtualMemorySimulator::setEventSink(EventSink* event_sink) {
+    sink = activeSink(event_sink);
+}
+
+// Replace the TLBs (config.l1.lines == 0 removes them); they start empty
+bool VirtualMemorySimulator::configureTlb(const TlbConfig& config) {
+    if (config.l1.lines < 0 || config.l2.lines < 0 ||
+        (config.l1.lines == 0 && config.l2.lines > 0) ||
+        config.l1_latency < 0 || config.l2_latency < 0 || config.walk_latency < 0) {
+        return false;
+    }
+    
+    delete l1_tlb;
+    delete l2_tlb;
+    l1_tlb = nullptr;
+    l2_tlb = nullptr;
+    tlb_config = config;
+    tlb_config.l1.block_size = 1;
+    tlb_config.l2.block_size = 1;
+    
+    if (tlb_config.l1.lines > 0) l1_tlb = new Cache("L1 dTLB", tlb_config.l1);
+    if (tlb_config.l2.lines > 0) l2_tlb = new Cache("L2 TLB", tlb_config.l2);
+    return true;
+}
+
+// Helper: Look the page up in the TLBs and charge the lookup; an L2 hit
+// refills L1. Returns true if every level missed and the page table
+// has to be walked.
+bool VirtualMemorySimulator::lookupTlb(uint64_t page_number) {
+    tlb_lookups++;
+    translation_cycles += tlb_config.l1_latency;
+    if (l1_tlb->read(page_number)) {
+        l1_tlb_hits++;
+        return false;
+    }
+    
+    if (l2_tlb) {
+        translation_cycles += tlb_config.l2_latency;
+        if (l2_tlb->read(page_number)) {
+            l2_tlb_hits++;
+            l1_tlb->insert(page_number);
+            return false;
+        }
+    }
+    
+    page_walks++;
+    translation_cycles += tlb_config.walk_latency;
+    return true;
+}
+
+// Helper: Install a walked translation in every TLB level
+void VirtualMemorySimulator::fillTlb(uint64_t page_number) {
+    l1_tlb->insert(page_number);
+    if (l2_tlb) l2_tlb->insert(page_number);
 }
 
 // Translate virtual address to physical address
-size_t VirtualMemorySimulator::translateAddress(size_t virtual_address) {
+size_t VirtualMemorySimulator::translateAddress(size_t virtual_address, bool is_write) {
     total_accesses++;
     current_time++;
     
     // Check if address is valid
     if (virtual_address >= virtual_memory_size) {
-        cout << "ERROR: Virtual address 0x" << hex << virtual_address << dec
-                << " exceeds virtual memory size!\n";
+        if (sink) sink->emit(SimEvent(SimEventType::VM_ADDRESS_INVALID, virtual_address));
         return -1;
     }
     
     // Extract page number and offset
-    int page_number = virtual_address / page_size;
-    int offset = virtual_address % page_size;
+    uint64_t page_number = virtual_address / page_size;
+    size_t offset = virtual_address % page_size;
     
-    if (verbose) {
-        cout << "\n--- Address Translation ---\n";
-        cout << "Virtual address: 0x" << hex << virtual_address << dec << " (" << virtual_address << ")\n";
-        cout << "Page number: " << page_number << "\n";
-        cout << "Offset: " << offset << "\n";
-    }
+    if (sink) sink->emit(SimEvent(SimEventType::VM_TRANSLATE, virtual_address, page_number, offset));
+    
+    // TLB lookup; a page walk ends with the translation cached
+    bool walked = l1_tlb && lookupTlb(page_number);
     
-    // Check if page is in physical memory
-    PageTableEntry& pte = page_table[page_number];
+    // Walk the page table (tables are created on first touch); a TLB
+    // hit skips the walk's cost but not the bookkeeping
+    PageTableEntry& pte = *findEntry(page_number, true);
+    if (!l1_tlb || walked) levels_walked += page_table_levels;
     
     if (pte.valid) {
         // PAGE HIT
         page_hits++;
         pte.last_access_time = current_time;
         pte.access_count++;
+        pte.referenced = true;
+        if (is_write) pte.dirty = true;
+        
+        // Most recently used moves to the tail
+        unlinkFrame(recency_order, pte.frame_number);
+        linkFrame(recency_order, pte.frame_number);
+        if (walked) fillTlb(page_number);
         
         // Calculate physical address
         size_t physical_address = (pte.frame_number * page_size) + offset;
         
-        if (verbose) {
-            cout << "Result: PAGE HIT\n";
-            cout << "Frame number: " << pte.frame_number << "\n";
-            cout << "Physical address: 0x" << hex << physical_address << dec << " (" << physical_address << ")\n";
-        } else {
-            cout << "Virtual 0x" << hex << virtual_address << " → Physical 0x" << physical_address << dec;
-            cout << " [HIT]\n";
+        if (sink) {
+            sink->emit(SimEvent(SimEventType::VM_PAGE_HIT, virtual_address, pte.frame_number, physical_address));
         }
         
         return physical_address;
@@ -125,134 +318,198 @@ size_t VirtualMemorySimulator::translateAddress(size_t virtual_address) {
         // PAGE FAULT
         page_faults++;
         
-        if (verbose) {
-            cout << "Result: PAGE FAULT\n";
-        } else {
-            cout << "Virtual 0x" << hex << virtual_address << dec << " [FAULT] ";
-        }
+        if (sink) sink->emit(SimEvent(SimEventType::VM_PAGE_FAULT, virtual_address, page_number));
         
         // Handle page fault
         handlePageFault(page_number);
+        if (is_write && pte.valid) pte.dirty = true;
+        if (walked && pte.valid) fillTlb(page_number);
         
         // Now calculate physical address
         size_t physical_address = (pte.frame_number * page_size) + offset;
         
-        if (!verbose) {
-            cout << "→ Physical 0x" << hex << physical_address << dec << "\n";
-        }
+        if (sink) sink->emit(SimEvent(SimEventType::VM_FAULT_RESOLVED, physical_address));
         
         return physical_address;
     }
 }
 
 // Handle page fault
-void VirtualMemorySimulator::handlePageFault(int page_number) {
-    if (verbose) {
-        cout << "Handling page fault for page " << page_number << "...\n";
-    }
+void VirtualMemorySimulator::handlePageFault(uint64_t page_number) {
+    // Aging ticks once per fault
+    if (policy == PageReplacementPolicy::AGING) ageResidentPages();
     
     // Find free frame or select victim
     int free_frame = findFreeFrame();
     
     if (free_frame == -1) {
         // No free frame - must evict a page
-        if (verbose) {
-            cout << "No free frames. Selecting victim page...\n";
-        }
+        if (sink) sink->emit(SimEvent(SimEventType::VM_NO_FREE_FRAME));
         
-        int victim_page = selectVictimPage();
+        uint64_t victim_page = selectVictimPage();
         
-        if (victim_page == -1) {
-            cout << "ERROR: Could not find victim page!\n";
+        if (victim_page == NO_PAGE) {
+            if (sink) sink->emit(SimEvent(SimEventType::VM_VICTIM_MISSING));
             return;
         }
         
         // Evict victim page
         free_frame = evictPage(victim_page);
     } else {
-        if (verbose) {
-            cout << "Found free frame: " << free_frame << "\n";
-        }
+        if (sink) sink->emit(SimEvent(SimEventType::VM_FREE_FRAME, free_frame));
     }
     
     // Load page into frame
     loadPage(page_number, free_frame);
 }
 
-// Find a free frame
+// Find a free frame (the lowest-numbered one)
 int VirtualMemorySimulator::findFreeFrame() {
-    for (int i = 0; i < num_physical_frames; i++) {
-        if (!frame_used[i]) {
-            return i;
-        }
-    }
-    return -1;  // No free frame
+    if (free_frames == 0) return -1;  // No free frame
+    
+    while (free_frame_bits[free_word_hint] == 0) free_word_hint++;
+    return free_word_hint * 64 + __builtin_ctzll(free_frame_bits[free_word_hint]);
 }
 
 // Select victim page using replacement policy
-int VirtualMemorySimulator::selectVictimPage() {
-    int victim = -1;
+uint64_t VirtualMemorySimulator::selectVictimPage() {
+    if (free_frames == num_physical_frames) return NO_PAGE;  // Nothing resident
+    
+    uint64_t victim = NO_PAGE;
+    uint64_t moves_before = hand_movements;
+    
+    switch (policy) {
+        case PageReplacementPolicy::FIFO:
+            // FIFO: earliest loaded page
+            victim = frame_to_page[load_order.head];
+            break;
+        case PageReplacementPolicy::LRU:
+            // LRU: least recently accessed page
+            victim = frame_to_page[recency_order.head];
+            break;
+        case PageReplacementPolicy::CLOCK:
+            victim = clockVictim();
+            break;
+        case PageReplacementPolicy::SECOND_CHANCE:
+            victim = secondChanceVictim();
+            break;
+        case PageReplacementPolicy::ENHANCED_CLOCK:
+            victim = enhancedClockVictim();
+            break;
+        case PageReplacementPolicy::AGING:
+            victim = agingVictim();
+            break;
+    }
     
-    if (policy == PageReplacementPolicy::FIFO) {
-        // FIFO: Select page with earliest load time
-        int min_load_time = INT32_MAX;
-        
-        for (int i = 0; i < num_physical_frames; i++) {
-            int page_idx = frame_to_page[i];
-            if (page_idx != -1 && page_table[page_idx].valid) {
-                if (page_table[page_idx].load_time < min_load_time) {
-                    min_load_time = page_table[page_idx].load_time;
-                    victim = page_idx;
-                }
-            }
-        }
-        
-        if (verbose && victim != -1) {
-            cout << "FIFO selected victim: Page " << victim 
-                    << " (load_time=" << page_table[victim].load_time << ")\n";
-        }
+    if (sink && victim != NO_PAGE) {
+        // FIFO: load time, LRU: last access, aging: register, clocks: hand movements
+        const PageTableEntry& pte = *findEntry(victim, false);
+        uint64_t stamp = hand_movements - moves_before;
+        if (policy == PageReplacementPolicy::FIFO) stamp = pte.load_time;
+        if (policy == PageReplacementPolicy::LRU) stamp = pte.last_access_time;
+        if (policy == PageReplacementPolicy::AGING) stamp = pte.age;
+        sink->emit(SimEvent(SimEventType::VM_VICTIM_SELECTED, victim, stamp, (uint64_t)policy));
+    }
+    
+    return victim;
+}
+
+// Helper: Frame under the clock hand; the hand then moves one frame on
+int VirtualMemorySimulator::advanceClockHand() {
+    int frame = clock_hand;
+    clock_hand = (clock_hand + 1) % num_physical_frames;
+    hand_movements++;
+    return frame;
+}
+
+// Helper: Clock - the first unreferenced page under the hand; referenced
+// pages it passes lose their bit
+uint64_t VirtualMemorySimulator::clockVictim() {
+    while (true) {
+        int frame = advanceClockHand();
+        if (frame_to_page[frame] == NO_PAGE) continue;
         
-    } else if (policy == PageReplacementPolicy::LRU) {
-        // LRU: Select page with oldest access time
-        int min_access_time = INT32_MAX;
+        PageTableEntry& pte = *frame_to_pte[frame];
+        if (!pte.referenced) return frame_to_page[frame];
+        pte.referenced = false;
+    }
+}
+
+// Helper: Second-Chance - FIFO order, but a referenced oldest page is
+// cleared and moved to the back of the queue instead of evicted
+uint64_t VirtualMemorySimulator::secondChanceVictim() {
+    while (true) {
+        int frame = load_order.head;
+        hand_movements++;
         
+        PageTableEntry& pte = *frame_to_pte[frame];
+        if (!pte.referenced) return frame_to_page[frame];
+        pte.referenced = false;
+        unlinkFrame(load_order, frame);
+        linkFrame(load_order, frame);
+    }
+}
+
+// Helper: Enhanced Clock - sweep for an unreferenced clean page, then
+// for an unreferenced dirty page while clearing reference bits; the
+// second round always finds one
+uint64_t VirtualMemorySimulator::enhancedClockVictim() {
+    for (int round = 0; round < 2; round++) {
         for (int i = 0; i < num_physical_frames; i++) {
-            int page_idx = frame_to_page[i];
-            if (page_idx != -1 && page_table[page_idx].valid) {
-                if (page_table[page_idx].last_access_time < min_access_time) {
-                    min_access_time = page_table[page_idx].last_access_time;
-                    victim = page_idx;
-                }
-            }
+            int frame = advanceClockHand();
+            if (frame_to_page[frame] == NO_PAGE) continue;
+            
+            const PageTableEntry& pte = *frame_to_pte[frame];
+            if (!pte.referenced && !pte.dirty) return frame_to_page[frame];
         }
-        
-        if (verbose && victim != -1) {
-            cout << "LRU selected victim: Page " << victim 
-                    << " (last_access=" << page_table[victim].last_access_time << ")\n";
+        for (int i = 0; i < num_physical_frames; i++) {
+            int frame = advanceClockHand();
+            if (frame_to_page[frame] == NO_PAGE) continue;
+            
+            PageTableEntry& pte = *frame_to_pte[frame];
+            if (!pte.referenced && pte.dirty) return frame_to_page[frame];
+            pte.referenced = false;
         }
     }
-    
-    return victim;
+    return NO_PAGE;
+}
+
+// Helper: Aging - the page with the lowest register; ties go to the
+// earliest loaded page
+uint64_t VirtualMemorySimulator::agingVictim() {
+    int victim = -1;
+    for (int frame = load_order.head; frame != -1; frame = load_order.next[frame]) {
+        if (victim == -1 || frame_to_pte[frame]->age < frame_to_pte[victim]->age) victim = frame;
+    }
+    return (victim == -1) ? NO_PAGE : frame_to_page[victim];
+}
+
+// Helper: Shift each resident page's reference bit into the top of its
+// aging register and clear it
+void VirtualMemorySimulator::ageResidentPages() {
+    uint32_t top_bit = uint32_t(1) << (aging_bits - 1);
+    for (int frame = load_order.head; frame != -1; frame = load_order.next[frame]) {
+        PageTableEntry& pte = *frame_to_pte[frame];
+        pte.age = (pte.age >> 1) | (pte.referenced ? top_bit : 0);
+        pte.referenced = false;
+    }
 }
 
 // Evict a page from memory
-int VirtualMemorySimulator::evictPage(int page_number) {
-    PageTableEntry& pte = page_table[page_number];
+int VirtualMemorySimulator::evictPage(uint64_t page_number) {
+    PageTableEntry* entry = findEntry(page_number, false);
     
-    if (!pte.valid) {
-        cout << "ERROR: Trying to evict invalid page!\n";
+    if (!entry || !entry->valid) {
+        if (sink) sink->emit(SimEvent(SimEventType::VM_EVICT_INVALID));
         return -1;
     }
     
+    PageTableEntry& pte = *entry;
     int frame = pte.frame_number;
     
-    if (verbose) {
-        cout << "Evicting page " << page_number << " from frame " << frame;
-        if (pte.dirty) {
-            cout << " (dirty - writing to disk)";
-            disk_writes++;
-        }
-        cout << "\n";
+    if (sink) {
+        sink->emit(SimEvent(SimEventType::VM_PAGE_EVICTED, page_number, frame, 0, 0, 0,
+                            pte.dirty ? EVENT_DIRTY : 0));
     }
     
     // If page is dirty, write to disk (simulated)
@@ -260,25 +517,31 @@ int VirtualMemorySimulator::evictPage(int page_number) {
         disk_writes++;
     }
     
+    // Shoot the stale translation down from the TLBs
+    bool was_dirty;
+    if (l1_tlb) l1_tlb->invalidate(page_number, was_dirty);
+    if (l2_tlb) l2_tlb->invalidate(page_number, was_dirty);
+    
     // Invalidate page table entry
     pte.valid = false;
     pte.frame_number = -1;
     pte.dirty = false;
     
     // Mark frame as free
-    frame_to_page[frame] = -1;
-    frame_used[frame] = false;
+    unlinkFrame(load_order, frame);
+    unlinkFrame(recency_order, frame);
+    frame_to_page[frame] = NO_PAGE;
+    frame_to_pte[frame] = nullptr;
+    setFrameFree(frame, true);
     
     return frame;
 }
 
 // Load page into frame
-void VirtualMemorySimulator::loadPage(int page_number, int frame_number) {
-    PageTableEntry& pte = page_table[page_number];
+void VirtualMemorySimulator::loadPage(uint64_t page_number, int frame_number) {
+    PageTableEntry& pte = *findEntry(page_number, true);
     
-    if (verbose) {
-        cout << "Loading page " << page_number << " into frame " << frame_number << "\n";
-    }
+    if (sink) sink->emit(SimEvent(SimEventType::VM_PAGE_LOADED, page_number, frame_number));
     
     // Simulate disk read
     disk_reads++;
@@ -287,13 +550,18 @@ void VirtualMemorySimulator::loadPage(int page_number, int frame_number) {
     pte.valid = true;
     pte.frame_number = frame_number;
     pte.dirty = false;
+    pte.referenced = true;
+    pte.age = 0;
     pte.load_time = current_time;
     pte.last_access_time = current_time;
     pte.access_count++;
     
     // Update frame tracking
     frame_to_page[frame_number] = page_number;
-    frame_used[frame_number] = true;
+    frame_to_pte[frame_number] = &pte;
+    setFrameFree(frame_number, false);
+    linkFrame(load_order, frame_number);
+    linkFrame(recency_order, frame_number);
 }
 
 // Access a virtual address (simplified interface)
@@ -301,41 +569,54 @@ void VirtualMemorySimulator::access(size_t virtual_address) {
     translateAddress(virtual_address);
 }
 
-// Display page table
+// Helper: One row of the page table display
+static void printPageTableRow(uint64_t page_number, const PageTableEntry& pte) {
+    cout << "Page " << setw(3) << page_number << " | ";
+    cout << (pte.valid ? "  YES " : "  NO  ") << " | ";
+    
+    if (pte.valid) {
+        cout << setw(3) << pte.frame_number << "   | ";
+        cout << (pte.dirty ? " YES " : " NO  ") << " | ";
+        cout << setw(5) << pte.load_time << "     | ";
+        cout << setw(6) << pte.last_access_time << "      | ";
+        cout << setw(4) << pte.access_count;
+    } else {
+        cout << "  -   |   -   |     -     |      -      |    -    ";
+    }
+    
+    cout << "\n";
+}
+
+// Display page table (every page of a small space, else resident pages)
 void VirtualMemorySimulator::displayPageTable() {
     cout << "\n=== PAGE TABLE ===\n";
     cout << "Format: Page | Valid | Frame | Dirty | Load_Time | Last_Access | Accesses\n\n";
     
-    for (int i = 0; i < num_virtual_pages; i++) {
-        PageTableEntry& pte = page_table[i];
-        
-        cout << "Page " << setw(3) << i << " | ";
-        cout << (pte.valid ? "  YES " : "  NO  ") << " | ";
-        
-        if (pte.valid) {
-            cout << setw(3) << pte.frame_number << "   | ";
-            cout << (pte.dirty ? " YES " : " NO  ") << " | ";
-            cout << setw(5) << pte.load_time << "     | ";
-            cout << setw(6) << pte.last_access_time << "      | ";
-            cout << setw(4) << pte.access_count;
-        } else {
-            cout << "  -   |   -   |     -     |      -      |    -    ";
+    vector<uint64_t> resident;
+    for (int frame = 0; frame < num_physical_frames; frame++) {
+        if (frame_to_page[frame] != NO_PAGE) resident.push_back(frame_to_page[frame]);
+    }
+    sort(resident.begin(), resident.end());
+    
+    if (num_virtual_pages <= PAGE_TABLE_DISPLAY_LIMIT) {
+        PageTableEntry untouched;
+        for (uint64_t i = 0; i < num_virtual_pages; i++) {
+            PageTableEntry* pte = findEntry(i, false);
+            printPageTableRow(i, pte ? *pte : untouched);
+        }
+    } else {
+        for (uint64_t page : resident) {
+            printPageTableRow(page, *findEntry(page, false));
         }
-        
-        cout << "\n";
     }
     
     cout << "\nPages in memory: ";
-    int count = 0;
-    for (int i = 0; i < num_virtual_pages; i++) {
-        if (page_table[i].valid) {
-            if (count > 0) cout << ", ";
-            cout << i;
-            count++;
-        }
+    for (size_t i = 0; i < resident.size(); i++) {
+        if (i > 0) cout << ", ";
+        cout << resident[i];
     }
-    if (count == 0) cout << "None";
-    cout << " (" << count << "/" << num_physical_frames << " frames used)\n";
+    if (resident.empty()) cout << "None";
+    cout << " (" << resident.size() << "/" << num_physical_frames << " frames used)\n";
 }
 
 // Display frame allocation
@@ -346,7 +627,7 @@ void VirtualMemorySimulator::displayFrames() {
     for (int i = 0; i < num_physical_frames; i++) {
         cout << "Frame " << setw(2) << i << " | ";
         
-        if (frame_used[i]) {
+        if (frame_to_page[i] != NO_PAGE) {
             cout << "Page " << setw(2) << frame_to_page[i] << " | USED";
         } else {
             cout << "  -    | FREE";
@@ -364,7 +645,7 @@ void VirtualMemorySimulator::displayStats() {
     cout << "  Virtual memory: " << virtual_memory_size << " bytes (" << num_virtual_pages << " pages)\n";
     cout << "  Physical memory: " << physical_memory_size << " bytes (" << num_physical_frames << " frames)\n";
     cout << "  Page size: " << page_size << " bytes\n";
-    cout << "  Replacement policy: " << (policy == PageReplacementPolicy::FIFO ? "FIFO" : "LRU") << "\n";
+    cout << "  Replacement policy: " << policyLabel() << "\n";
     
     cout << "\nMemory Access Statistics:\n";
     cout << "  Total accesses: " << total_accesses << "\n";
@@ -379,16 +660,35 @@ void VirtualMemorySimulator::displayStats() {
         cout << "  Fault rate: " << fixed << setprecision(2) << fault_rate << "%\n";
     }
     
+    bool uses_hand = (policy == PageReplacementPolicy::CLOCK ||
+                      policy == PageReplacementPolicy::SECOND_CHANCE ||
+                      policy == PageReplacementPolicy::ENHANCED_CLOCK);
+    if (uses_hand || hand_movements > 0) {
+        double per_fault = (page_faults > 0) ? (double)hand_movements / page_faults : 0.0;
+        cout << "  Hand movements: " << hand_movements << " (" << fixed << setprecision(2)
+             << per_fault << " per fault)\n";
+    }
+    
+    // Radix table footprint against one flat entry per virtual page
+    double walk_depth = (total_accesses > 0) ? (double)levels_walked / total_accesses : 0.0;
+    cout << "\nPage Table:\n";
+    cout << "  Levels: " << page_table_levels << " (root " << (uint64_t(1) << root_bits) << " entries";
+    if (page_table_levels > 1) cout << ", " << (1 << TABLE_BITS) << " per lower table";
+    cout << ")\n";
+    cout << "  Tables allocated: " << page_table.size() << " (" << page_table_entries * PTE_BYTES
+         << " bytes; flat table: " << num_virtual_pages * PTE_BYTES << " bytes)\n";
+    cout << "  Levels walked: " << levels_walked << " (" << fixed << setprecision(2)
+         << walk_depth << " per access)\n";
+    
+    if (l1_tlb) displayTlbStats();
+    
     cout << "\nDisk Operations (Simulated):\n";
     cout << "  Disk reads: " << disk_reads << "\n";
     cout << "  Disk writes: " << disk_writes << "\n";
     cout << "  Total disk I/O: " << (disk_reads + disk_writes) << "\n";
     
     // Frame utilization
-    int frames_used = 0;
-    for (int i = 0; i < num_physical_frames; i++) {
-        if (frame_used[i]) frames_used++;
-    }
+    int frames_used = num_physical_frames - free_frames;
     
     double utilization = (double)frames_used / num_physical_frames * 100.0;
     
@@ -397,6 +697,36 @@ void VirtualMemorySimulator::displayStats() {
     cout << "  Utilization: " << fixed << setprecision(2) << utilization << "%\n";
 }
 
+// Helper: One TLB level's geometry, reach and hit rate
+static void printTlbLevel(const Cache& tlb, ReplacementPolicy replacement, size_t page_size,
+                          uint64_t lookups, uint64_t hits) {
+    // Reach: memory the level maps without a page walk
+    uint64_t reach = (uint64_t)tlb.getCapacity() * page_size;
+    double hit_rate = (lookups > 0) ? (double)hits / lookups * 100.0 : 0.0;
+    
+    cout << "  " << tlb.getName() << ": " << tlb.getCapacity() << " entries, " << tlb.getWays()
+         << "-way, " << replacementPolicyName(replacement) << " (reach " << reach << " bytes)\n";
+    cout << "    Hits: " << hits << ", Misses: " << (lookups - hits)
+         << " (hit rate " << fixed << setprecision(2) << hit_rate << "%)\n";
+}
+
+// Helper: TLB statistics, shown once a TLB is configured
+void VirtualMemorySimulator::displayTlbStats() {
+    cout << "\nTLB:\n";
+    printTlbLevel(*l1_tlb, tlb_config.l1.replacement, page_size, tlb_lookups, l1_tlb_hits);
+    if (l2_tlb) {
+        printTlbLevel(*l2_tlb, tlb_config.l2.replacement, page_size, tlb_lookups - l1_tlb_hits, l2_tlb_hits);
+    }
+    
+    double walk_rate = (tlb_lookups > 0) ? (double)page_walks / tlb_lookups * 100.0 : 0.0;
+    cout << "  Page walks: " << page_walks << " (" << fixed << setprecision(2) << walk_rate
+         << "% of translations, " << tlb_config.walk_latency << " cycles each)\n";
+    
+    double per_access = (tlb_lookups > 0) ? (double)translation_cycles / tlb_lookups : 0.0;
+    cout << "  Translation cycles: " << translation_cycles << " (" << fixed << setprecision(2)
+         << per_access << " per access)\n";
+}
+
 // Clear all statistics
 void VirtualMemorySimulator::clearStats() {
     page_faults = 0;
@@ -405,6 +735,13 @@ void VirtualMemorySimulator::clearStats() {
     disk_reads = 0;
     disk_writes = 0;
     current_time = 0;
+    hand_movements = 0;
+    levels_walked = 0;
+    tlb_lookups = 0;
+    l1_tlb_hits = 0;
+    l2_tlb_hits = 0;
+    page_walks = 0;
+    translation_cycles = 0;
     
     cout << "Statistics cleared\n";
 }
@@ -412,18 +749,54 @@ void VirtualMemorySimulator::clearStats() {
 // Reset simulator
 void VirtualMemorySimulator::reset() {
     // Clear page table
-    for (int i = 0; i < num_virtual_pages; i++) {
-        page_table[i] = PageTableEntry();
-    }
+    resetPageTable();
     
     // Clear frame allocation
-    for (int i = 0; i < num_physical_frames; i++) {
-        frame_to_page[i] = -1;
-        frame_used[i] = false;
-    }
+    resetFrames();
+    clock_hand = 0;
+    if (l1_tlb) l1_tlb->clear();
+    if (l2_tlb) l2_tlb->clear();
     
     // Clear statistics
     clearStats();
     
     cout << "Virtual memory simulator reset\n";
-}
\ No newline at end of file
+}
+
+// ==================== HELPER FUNCTIONS ====================
+
+bool parsePageReplacementPolicy(const string& policy_str, PageReplacementPolicy& policy, int& aging_bits) {
+    if (policy_str == "fifo") policy = PageReplacementPolicy::FIFO;
+    else if (policy_str == "lru") policy = PageReplacementPolicy::LRU;
+    else if (policy_str == "clock") policy = PageReplacementPolicy::CLOCK;
+    else if (policy_str == "second_chance") policy = PageReplacementPolicy::SECOND_CHANCE;
+    else if (policy_str == "enhanced_clock") policy = PageReplacementPolicy::ENHANCED_CLOCK;
+    else if (policy_str.compare(0, 5, "aging") == 0) {
+        int bits = 8;
+        if (policy_str.size() > 5) {
+            if (policy_str[5] != ':') return false;
+            try {
+                bits = stoi(policy_str.substr(6));
+            } catch (...) {
+                return false;
+            }
+        }
+        if (bits < 1 || bits > 32) return false;
+        policy = PageReplacementPolicy::AGING;
+        aging_bits = bits;
+    }
+    else return false;
+    return true;
+}
+
+string pageReplacementPolicyName(PageReplacementPolicy policy) {
+    switch (policy) {
+        case PageReplacementPolicy::FIFO: return "FIFO";
+        case PageReplacementPolicy::LRU: return "LRU";
+        case PageReplacementPolicy::CLOCK: return "CLOCK";
+        case PageReplacementPolicy::SECOND_CHANCE: return "SECOND-CHANCE";
+        case PageReplacementPolicy::ENHANCED_CLOCK: return "ENHANCED-CLOCK";
+        case PageReplacementPolicy::AGING: return "AGING";
+    }
+    return "FIFO";
+}